@@ -32,8 +32,10 @@
 
 /*..........................................................................*/
 static void print_str(char const *str);
-static void print_dec(unsigned const num);
+static void print_dec(unsigned long const num);
 static void print_summary(unsigned ok);
+static void print_perf(void);
+static void print_x100(unsigned long const num);
 static void test_end(void);
 static int  str_cmp(char const *str1, char const *str2);
 
@@ -41,6 +43,15 @@ static unsigned l_test_count;
 static unsigned l_skip_count;
 static unsigned l_skip_last;
 
+static unsigned      l_perf_valid;
+static unsigned long l_perf_ops_per_sec;
+static unsigned long l_perf_cycles_per_op_x100;
+
+#define ET_PERF_MAX_COUNTERS 8U
+static char const   *l_perf_ctr_name[ET_PERF_MAX_COUNTERS];
+static unsigned long l_perf_ctr_x100[ET_PERF_MAX_COUNTERS];
+static unsigned      l_perf_n_ctr;
+
 static char const *l_expect_assert_module;
 static int         l_expect_assert_label;
 
@@ -79,6 +90,8 @@ int ET_test_(char const *title, int skip) {
         ET_onPrintChar('.');
     }
     l_skip_last = skip;
+    l_perf_valid = 0U;
+    l_perf_n_ctr = 0U;
     return skip == 0;
 }
 /*..........................................................................*/
@@ -94,7 +107,9 @@ static void test_end(void) {
         }
         else {
             teardown();
-            print_str(". PASSED\n");
+            print_str(". PASSED");
+            print_perf();
+            ET_onPrintChar('\n');
         }
     }
 }
@@ -112,6 +127,22 @@ void ET_fail(char const *cond, char const *group, int line) {
     ET_onExit(-1); /* failure */
 }
 /*..........................................................................*/
+void ET_perf_result_(unsigned long ops_per_sec,
+                     unsigned long cycles_per_op_x100)
+{
+    l_perf_ops_per_sec = ops_per_sec;
+    l_perf_cycles_per_op_x100 = cycles_per_op_x100;
+    l_perf_valid = 1U;
+}
+/*..........................................................................*/
+void ET_perf_counter_(char const *name, unsigned long per_op_x100) {
+    if (l_perf_n_ctr < ET_PERF_MAX_COUNTERS) {
+        l_perf_ctr_name[l_perf_n_ctr] = name;
+        l_perf_ctr_x100[l_perf_n_ctr] = per_op_x100;
+        ++l_perf_n_ctr;
+    }
+}
+/*..........................................................................*/
 void ET_expect_assert(char const *module, int label) {
     l_expect_assert_module = module;
     l_expect_assert_label = label;
@@ -143,6 +174,30 @@ static void print_summary(unsigned ok) {
     print_str(ok ? "OK\n" : "FAILED\n");
 }
 /*..........................................................................*/
+static void print_perf(void) {
+    if (l_perf_valid) {
+        print_str(" ops/s: ");
+        print_dec(l_perf_ops_per_sec);
+        if (l_perf_cycles_per_op_x100 != 0U) { /* cycles known? */
+            print_str(" cycles/op: ");
+            print_x100(l_perf_cycles_per_op_x100);
+        }
+        for (unsigned i = 0U; i < l_perf_n_ctr; ++i) {
+            ET_onPrintChar(' ');
+            print_str(l_perf_ctr_name[i]);
+            print_str("/op: ");
+            print_x100(l_perf_ctr_x100[i]);
+        }
+    }
+}
+/*..........................................................................*/
+static void print_x100(unsigned long const num) { /* num/100 with 2 digits */
+    print_dec(num / 100U);
+    ET_onPrintChar('.');
+    print_dec((num / 10U) % 10U);
+    print_dec(num % 10U);
+}
+/*..........................................................................*/
 static void print_str(char const *str) {
     for (; *str != '\0'; ++str) {
         ET_onPrintChar(*str);
@@ -150,10 +205,10 @@ static void print_str(char const *str) {
 }
 
 /*..........................................................................*/
-static void print_dec(unsigned const num) {
+static void print_dec(unsigned long const num) {
     /* find power of 10 of the first decimal digit of the number */
-    unsigned pwr10 = 1U;
-    for (; num > (pwr10 * 9U); pwr10 *= 10U) {
+    unsigned long pwr10 = 1U;
+    for (; (num / pwr10) >= 10U; pwr10 *= 10U) {
     }
     /* print the decimal digits of the number... */
     do {
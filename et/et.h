@@ -43,6 +43,10 @@
 #define TEST(title_) \
     if (ET_test_(title_, 0))
 
+/* macro to start a new performance test (ET ports with ET_perf_setup()) */
+#define PERF_TEST(title_, n_ops_, msec_) \
+    if (ET_test_(title_, 0) && ET_perf_setup((n_ops_), (msec_)))
+
 /* macro to skip a test */
 #define SKIP_TEST(title_) \
     if (ET_test_(title_, 1))
@@ -75,6 +79,19 @@ void ET_onInit(int argc, char *argv[]);
 void ET_onPrintChar(char const ch);
 void ET_onExit(int err);
 
+/*! performance test worker
+*
+* The worker performs n_ops operations, but stops earlier when
+* ET_perf_stop() returns non-zero. It returns the operations performed.
+*/
+typedef unsigned long (*ET_PerfWorker)(void *arg, unsigned long n_ops);
+
+/* performance tests, implemented in the ET ports (currently host only) */
+int  ET_perf_setup(unsigned long n_ops, unsigned msec);
+void ET_perf_worker(ET_PerfWorker worker, void *arg, int cpu);
+void ET_perf_run(void);
+int  ET_perf_stop(void);
+
 /* public helpers */
 void ET_fail(char const *cond, char const *group, int line);
 void ET_expect_assert(char const *module, int label);
@@ -83,6 +100,9 @@ void ET_verify_assert_(char const *module, int label);
 /* private helpers */
 void ET_run_(void);
 int  ET_test_(char const *title, int skip);
+void ET_perf_result_(unsigned long ops_per_sec,
+                     unsigned long cycles_per_op_x100);
+void ET_perf_counter_(char const *name, unsigned long per_op_x100);
 extern char const ET_group_[];
 
 #ifdef __cplusplus
@@ -28,15 +28,101 @@
 * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
 * DEALINGS IN THE SOFTWARE.
 ============================================================================*/
+#ifdef __linux__
+#define _GNU_SOURCE /* for pthread_setaffinity_np() */
+#else
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include "et.h" /* ET: embedded test */
 
 #include <stdio.h>  /* for fputc() and stdout */
 #include <stdlib.h> /* for exit() */
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <pthread.h>
+#ifdef __linux__
+#include <sched.h>  /* for CPU_SET() */
+#include <string.h> /* for memset() */
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h> /* for __rdtsc() */
+#endif
+
+/* performance tests -------------------------------------------------------*/
+#define ET_PERF_MAX_WORKERS 16
+
+/* hardware performance counters (Linux perf_event_open(), optional) */
+#define ET_PERF_N_EVENTS 5
+
+typedef struct {
+    ET_PerfWorker worker;
+    void *arg;
+    int cpu;
+    unsigned long n_ops; /* operations performed by the worker */
+    pthread_t thread;
+    double counts[ET_PERF_N_EVENTS]; /* hardware event counts */
+    int valid[ET_PERF_N_EVENTS];     /* hardware event counted? */
+} PerfWorker;
+
+static PerfWorker l_perf_workers[ET_PERF_MAX_WORKERS];
+static unsigned l_perf_n_workers;
+static unsigned long l_perf_n_ops;
+static unsigned l_perf_msec;
+static atomic_int l_perf_stop;
+static pthread_barrier_t l_perf_barrier;
+
+#ifdef __linux__
+/* hardware events recorded when the ET_PERF_EVENTS environment variable
+* is set. The HITM event (cache-line transfers from a modified line in
+* another core's cache) is CPU-specific and must be provided as the raw
+* event code in the ET_PERF_HITM environment variable, for example
+* ET_PERF_HITM=0x04d2 (MEM_LOAD_L3_HIT_RETIRED.XSNP_HITM on Intel Skylake).
+*/
+static struct {
+    char const *name;
+    uint32_t type;
+    uint64_t config;
+} l_perf_events[ET_PERF_N_EVENTS] = {
+    { "cpu-cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES   },
+    { "instr",      PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "L1D-miss",   PERF_TYPE_HW_CACHE,
+      PERF_COUNT_HW_CACHE_L1D
+      | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { "LLC-miss",   PERF_TYPE_HW_CACHE,
+      PERF_COUNT_HW_CACHE_LL
+      | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+      | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) },
+    { "HITM",       PERF_TYPE_RAW, 0U /* from ET_PERF_HITM */ },
+};
+static int l_perf_events_on;
+
+static void perf_events_open(int fd[]);
+static void perf_events_close(int fd[], PerfWorker * const w);
+#endif /* __linux__ */
+
+static void *perf_thread(void *arg);
+static unsigned long long perf_cycles(void);
+static double perf_sec(void);
 
 /*..........................................................................*/
 void ET_onInit(int argc, char *argv[]) {
     (void)argc;
     (void)argv;
+#ifdef __linux__
+    l_perf_events_on = (getenv("ET_PERF_EVENTS") != (char *)0);
+    char const * const hitm = getenv("ET_PERF_HITM");
+    if (hitm != (char *)0) {
+        l_perf_events[ET_PERF_N_EVENTS - 1].config =
+            strtoull(hitm, (char **)0, 0);
+    }
+#endif
 }
 /*..........................................................................*/
 void ET_onPrintChar(char const ch) {
@@ -46,3 +132,166 @@ void ET_onPrintChar(char const ch) {
 void ET_onExit(int err) {
     exit(err);
 }
+
+/*..........................................................................*/
+int ET_perf_setup(unsigned long n_ops, unsigned msec) {
+    l_perf_n_workers = 0U;
+    l_perf_n_ops = (n_ops != 0U) ? n_ops : ~0UL; /* 0 means "until stop" */
+    l_perf_msec  = msec;
+    atomic_store(&l_perf_stop, 0);
+    return 1;
+}
+/*..........................................................................*/
+void ET_perf_worker(ET_PerfWorker worker, void *arg, int cpu) {
+    if (l_perf_n_workers >= ET_PERF_MAX_WORKERS) {
+        ET_fail("too many performance workers", ET_group_, __LINE__);
+    }
+    PerfWorker * const w = &l_perf_workers[l_perf_n_workers];
+    w->worker = worker;
+    w->arg    = arg;
+    w->cpu    = cpu;
+    w->n_ops  = 0U;
+    ++l_perf_n_workers;
+}
+/*..........................................................................*/
+void ET_perf_run(void) {
+    pthread_barrier_init(&l_perf_barrier, (pthread_barrierattr_t *)0,
+                         l_perf_n_workers + 1U);
+    for (unsigned i = 0U; i < l_perf_n_workers; ++i) {
+        pthread_create(&l_perf_workers[i].thread, (pthread_attr_t *)0,
+                       &perf_thread, &l_perf_workers[i]);
+    }
+    pthread_barrier_wait(&l_perf_barrier); /* start all workers at once */
+    double const t0 = perf_sec();
+    unsigned long long const c0 = perf_cycles();
+
+    if (l_perf_msec != 0U) { /* run for the given duration? */
+        struct timespec ts;
+        ts.tv_sec  = (time_t)(l_perf_msec / 1000U);
+        ts.tv_nsec = (long)(l_perf_msec % 1000U) * 1000000L;
+        nanosleep(&ts, (struct timespec *)0);
+        atomic_store(&l_perf_stop, 1);
+    }
+    unsigned long n_ops = 0U;
+    for (unsigned i = 0U; i < l_perf_n_workers; ++i) {
+        pthread_join(l_perf_workers[i].thread, (void **)0);
+        n_ops += l_perf_workers[i].n_ops;
+    }
+#ifdef __linux__
+    /* hardware events per operation, summed over all workers */
+    for (unsigned e = 0U; (n_ops != 0U) && (e < ET_PERF_N_EVENTS); ++e) {
+        double sum = 0.0;
+        int valid = 0;
+        for (unsigned i = 0U; i < l_perf_n_workers; ++i) {
+            if (l_perf_workers[i].valid[e]) {
+                sum += l_perf_workers[i].counts[e];
+                valid = 1;
+            }
+        }
+        if (valid) {
+            ET_perf_counter_(l_perf_events[e].name,
+                (unsigned long)(100.0 * sum / (double)n_ops));
+        }
+    }
+#endif
+
+    unsigned long long const c1 = perf_cycles();
+    double const t1 = perf_sec();
+    pthread_barrier_destroy(&l_perf_barrier);
+
+    if ((n_ops != 0U) && (t1 > t0)) {
+        /* cycles/op: cycles each worker spent on one of its operations */
+        ET_perf_result_((unsigned long)((double)n_ops / (t1 - t0)),
+            (unsigned long)(100.0 * (double)(c1 - c0)
+                            * (double)l_perf_n_workers / (double)n_ops));
+    }
+}
+/*..........................................................................*/
+int ET_perf_stop(void) {
+    return atomic_load_explicit(&l_perf_stop, memory_order_relaxed);
+}
+/*..........................................................................*/
+static void *perf_thread(void *arg) {
+    PerfWorker * const w = (PerfWorker *)arg;
+#ifdef __linux__
+    if (w->cpu >= 0) { /* pin the worker to the given CPU (if it exists) */
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(w->cpu, &set);
+        (void)pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    }
+    int fd[ET_PERF_N_EVENTS];
+    perf_events_open(fd);
+    pthread_barrier_wait(&l_perf_barrier);
+    for (unsigned e = 0U; e < ET_PERF_N_EVENTS; ++e) {
+        if (fd[e] >= 0) {
+            ioctl(fd[e], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    w->n_ops = (*w->worker)(w->arg, l_perf_n_ops);
+    perf_events_close(fd, w);
+#else
+    pthread_barrier_wait(&l_perf_barrier);
+    w->n_ops = (*w->worker)(w->arg, l_perf_n_ops);
+#endif
+    return (void *)0;
+}
+#ifdef __linux__
+/*..........................................................................*/
+static void perf_events_open(int fd[]) {
+    for (unsigned e = 0U; e < ET_PERF_N_EVENTS; ++e) {
+        fd[e] = -1;
+        if (!l_perf_events_on
+            || ((l_perf_events[e].type == PERF_TYPE_RAW)
+                && (l_perf_events[e].config == 0U)))
+        {
+            continue; /* event not requested */
+        }
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size   = sizeof(attr);
+        attr.type   = l_perf_events[e].type;
+        attr.config = l_perf_events[e].config;
+        attr.disabled       = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED
+                           | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        /* this thread on any CPU; failure (no PMU, no permission) is OK */
+        fd[e] = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+}
+/*..........................................................................*/
+static void perf_events_close(int fd[], PerfWorker * const w) {
+    for (unsigned e = 0U; e < ET_PERF_N_EVENTS; ++e) {
+        w->valid[e] = 0;
+        if (fd[e] < 0) {
+            continue;
+        }
+        ioctl(fd[e], PERF_EVENT_IOC_DISABLE, 0);
+        uint64_t val[3]; /* value, time enabled, time running */
+        if ((read(fd[e], val, sizeof(val)) == (ssize_t)sizeof(val))
+            && (val[2] != 0U))
+        {
+            /* scale the count if the counter was multiplexed */
+            w->counts[e] = (double)val[0] * (double)val[1] / (double)val[2];
+            w->valid[e] = 1;
+        }
+        close(fd[e]);
+    }
+}
+#endif /* __linux__ */
+/*..........................................................................*/
+static unsigned long long perf_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc(); /* time-stamp counter (TSC) */
+#else
+    return 0U; /* cycles unknown (not reported) */
+#endif
+}
+/*..........................................................................*/
+static double perf_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
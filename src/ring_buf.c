@@ -30,6 +30,7 @@
 //============================================================================
 #include <stdint.h>
 #include <stdbool.h>
+#include <string.h> // for memcpy()
 
 #include "ring_buf.h"
 
@@ -40,6 +41,9 @@ void RingBuf_ctor(RingBuf * const me,
     me->end  = sto_len;
     atomic_store(&me->head, 0U);  // initialize head atomically
     atomic_store(&me->tail, 0U);  // initialize tail atomically
+#ifdef RING_BUF_SNAPSHOT
+    atomic_store(&me->seq, 0U);
+#endif
 }
 //............................................................................
 bool RingBuf_put(RingBuf * const me, RingBufElement const el) {
@@ -66,9 +70,11 @@ bool RingBuf_get(RingBuf * const me, RingBufElement *pel) {
         *pel = me->buf[tail];
         ++tail;
         if (tail == me->end) {
-            tail = 0U;
+            RingBuf_wrap_tail_(me, 0U);
+        }
+        else {
+            atomic_store_explicit(&me->tail, tail, memory_order_release);
         }
-        atomic_store_explicit(&me->tail, tail, memory_order_release);
         return true;
     }
     else {
@@ -76,6 +82,62 @@ bool RingBuf_get(RingBuf * const me, RingBufElement *pel) {
     }
 }
 //............................................................................
+// Put up to 'n' elements with one head update (e.g., a burst from an ISR).
+// Returns the number of elements actually put (limited by the free space).
+RingBufCtr RingBuf_put_n(RingBuf * const me,
+                         RingBufElement const els[], RingBufCtr n)
+{
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_relaxed);
+    RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_acquire);
+    RingBufCtr n_free = (head < tail)
+                        ? (RingBufCtr)(tail - head - 1U)
+                        : (RingBufCtr)(me->end + tail - head - 1U);
+    if (n > n_free) {
+        n = n_free;
+    }
+    RingBufCtr const n_end = (RingBufCtr)(me->end - head); // up to the end
+    if (n < n_end) { // no wrap-around?
+        memcpy(&me->buf[head], &els[0], n * sizeof(RingBufElement));
+        head += n;
+    }
+    else {
+        memcpy(&me->buf[head], &els[0], n_end * sizeof(RingBufElement));
+        memcpy(&me->buf[0], &els[n_end],
+               (RingBufCtr)(n - n_end) * sizeof(RingBufElement));
+        head = (RingBufCtr)(n - n_end);
+    }
+    atomic_store_explicit(&me->head, head, memory_order_release);
+    return n;
+}
+//............................................................................
+// Get up to 'n' elements with one tail update.
+// Returns the number of elements actually removed.
+RingBufCtr RingBuf_get_n(RingBuf * const me,
+                         RingBufElement els[], RingBufCtr n)
+{
+    RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
+    RingBufCtr n_used = (head >= tail)
+                        ? (RingBufCtr)(head - tail)
+                        : (RingBufCtr)(me->end + head - tail);
+    if (n > n_used) {
+        n = n_used;
+    }
+    RingBufCtr const n_end = (RingBufCtr)(me->end - tail); // up to the end
+    if (n < n_end) { // no wrap-around?
+        memcpy(&els[0], &me->buf[tail], n * sizeof(RingBufElement));
+        atomic_store_explicit(&me->tail, (RingBufCtr)(tail + n),
+                              memory_order_release);
+    }
+    else {
+        memcpy(&els[0], &me->buf[tail], n_end * sizeof(RingBufElement));
+        memcpy(&els[n_end], &me->buf[0],
+               (RingBufCtr)(n - n_end) * sizeof(RingBufElement));
+        RingBuf_wrap_tail_(me, (RingBufCtr)(n - n_end));
+    }
+    return n;
+}
+//............................................................................
 RingBufCtr RingBuf_num_free(RingBuf * const me) {
     RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
     RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
@@ -99,7 +161,126 @@ void RingBuf_process_all(RingBuf * const me, RingBufHandler handler) {
         ++tail;
         if (tail == me->end) {
             tail = 0U;
+            RingBuf_wrap_tail_(me, tail);
+        }
+        else {
+            atomic_store_explicit(&me->tail, tail, memory_order_release);
         }
-        atomic_store_explicit(&me->tail, tail, memory_order_release);
     }
 }
+//............................................................................
+// Copy up to 'n' of the oldest elements without removing them.
+// Returns the number of elements copied. Called only by the consumer.
+RingBufCtr RingBuf_peek_n(RingBuf * const me,
+                          RingBufElement els[], RingBufCtr n)
+{
+    RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
+    RingBufCtr n_used = (head >= tail)
+                        ? (RingBufCtr)(head - tail)
+                        : (RingBufCtr)(me->end + head - tail);
+    if (n > n_used) {
+        n = n_used;
+    }
+    RingBufCtr const n_end = (RingBufCtr)(me->end - tail); // up to the end
+    if (n < n_end) { // no wrap-around?
+        memcpy(&els[0], &me->buf[tail], n * sizeof(RingBufElement));
+    }
+    else {
+        memcpy(&els[0], &me->buf[tail], n_end * sizeof(RingBufElement));
+        memcpy(&els[n_end], &me->buf[0],
+               (RingBufCtr)(n - n_end) * sizeof(RingBufElement));
+    }
+    return n;
+}
+//............................................................................
+void RingBufIter_ctor(RingBufIter * const me, RingBuf * const rb) {
+    me->rb   = rb;
+    me->pos  = atomic_load_explicit(&rb->tail, memory_order_relaxed);
+    me->head = atomic_load_explicit(&rb->head, memory_order_acquire);
+}
+//............................................................................
+bool RingBufIter_next(RingBufIter * const me, RingBufElement *pel) {
+    if (me->pos == me->head) { // end of the range?
+        return false;
+    }
+    *pel = me->rb->buf[me->pos];
+    ++me->pos;
+    if (me->pos == me->rb->end) {
+        me->pos = 0U;
+    }
+    return true;
+}
+#ifdef RING_BUF_SNAPSHOT
+//............................................................................
+// consumer's position: the sequence of the tail wrap-arounds (even) and
+// the tail, read consistently with the seqlock
+static uint32_t consumer_seq(RingBuf const * const me, RingBufCtr *ptail) {
+    for (;;) {
+        uint32_t const seq1 =
+            atomic_load_explicit(&me->seq, memory_order_acquire);
+        // acquire: seq2 below sees at least the odd seq stored before
+        // the tail read here (see RingBuf_wrap_tail_())
+        RingBufCtr const tail =
+            atomic_load_explicit(&me->tail, memory_order_acquire);
+        uint32_t const seq2 =
+            atomic_load_explicit(&me->seq, memory_order_relaxed);
+        if ((seq1 == seq2) && ((seq1 & 1U) == 0U)) { // consistent?
+            *ptail = tail;
+            return seq1;
+        }
+    }
+}
+//............................................................................
+// Copy up to 'n' of the oldest elements for an observer thread (neither
+// the producer nor the consumer). Returns the number of valid elements
+// in els[], which were all in the ring buffer at the end of the call.
+RingBufCtr RingBuf_snapshot(RingBuf * const me,
+                            RingBufElement els[], RingBufCtr n)
+{
+    RingBufCtr tail;
+    uint32_t const seq = consumer_seq(me, &tail);
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
+    RingBufCtr n_used = (head >= tail)
+                        ? (RingBufCtr)(head - tail)
+                        : (RingBufCtr)(me->end + head - tail);
+    if (n > n_used) {
+        n = n_used;
+    }
+    // the copy races with the producer overwriting the slots freed by
+    // the consumer in the meantime, which is detected below
+    RingBufCtr const n_end = (RingBufCtr)(me->end - tail); // up to the end
+    if (n < n_end) { // no wrap-around?
+        memcpy(&els[0], &me->buf[tail], n * sizeof(RingBufElement));
+    }
+    else {
+        memcpy(&els[0], &me->buf[tail], n_end * sizeof(RingBufElement));
+        memcpy(&els[n_end], &me->buf[0],
+               (RingBufCtr)(n - n_end) * sizeof(RingBufElement));
+    }
+    atomic_thread_fence(memory_order_acquire); // the copy before tail2
+
+    // the elements consumed during the copy from the difference of the
+    // wrap-around sequences (modulo 2^32, so seq can wrap around)
+    RingBufCtr tail2;
+    uint32_t const laps = (consumer_seq(me, &tail2) - seq) >> 1;
+    RingBufCtr consumed;
+    if (laps == 0U) {
+        consumed = (RingBufCtr)(tail2 - tail);
+    }
+    else if ((laps == 1U) && (tail2 < tail)) {
+        consumed = (RingBufCtr)(me->end - tail + tail2);
+    }
+    else { // the consumer moved by at least the whole length
+        return 0U;
+    }
+    if (consumed >= n) { // all copied elements removed?
+        return 0U;
+    }
+    if (consumed != 0U) { // keep only the elements that are still there
+        memmove(&els[0], &els[consumed],
+                (RingBufCtr)(n - consumed) * sizeof(RingBufElement));
+    }
+    return (RingBufCtr)(n - consumed);
+}
+#endif // RING_BUF_SNAPSHOT
@@ -34,6 +34,19 @@
 #include <stdatomic.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
+
+//! Size of the ring buffer counter/index [bytes] (1, 2, 4, or 8)
+//
+// @details
+// The default 2-byte (uint16_t) counter limits the ring buffer to 65535
+// elements, which is plenty for embedded systems. Large rings on host
+// computers can be configured by defining RING_BUF_CTR_SIZE as 4 or 8
+// on the command line, e.g. `-DRING_BUF_CTR_SIZE=4`.
+//
+#ifndef RING_BUF_CTR_SIZE
+#define RING_BUF_CTR_SIZE 2U
+#endif
 
 //! Ring buffer counter/index
 //
@@ -52,7 +65,43 @@
 //In practice, most C compilers should provide such natural alignment
 // (by inserting some padding into the ::RingBuf struct, if necessary).
 //
+// The assumptions are partially checked at compile time (see
+// RING_BUF_CTR_LOCK_FREE below), but the compiler cannot know about the
+// 8-bit CPU case, so the RING_BUF_CTR_SIZE still needs to be chosen with
+// the target CPU in mind.
+//
+#if (RING_BUF_CTR_SIZE == 1U)
+typedef uint8_t RingBufCtr;
+#define RING_BUF_CTR_LOCK_FREE ATOMIC_CHAR_LOCK_FREE
+#elif (RING_BUF_CTR_SIZE == 2U)
 typedef uint16_t RingBufCtr;
+#define RING_BUF_CTR_LOCK_FREE ATOMIC_SHORT_LOCK_FREE
+#elif (RING_BUF_CTR_SIZE == 4U)
+typedef uint32_t RingBufCtr;
+#if (UINT_MAX == 0xFFFFFFFFU)
+#define RING_BUF_CTR_LOCK_FREE ATOMIC_INT_LOCK_FREE
+#else
+#define RING_BUF_CTR_LOCK_FREE ATOMIC_LONG_LOCK_FREE
+#endif
+#elif (RING_BUF_CTR_SIZE == 8U)
+typedef uint64_t RingBufCtr;
+#define RING_BUF_CTR_LOCK_FREE ATOMIC_LLONG_LOCK_FREE
+#else
+#error "RING_BUF_CTR_SIZE defined incorrectly, expected 1U, 2U, 4U or 8U"
+#endif
+
+// ATOMIC_*_LOCK_FREE == 0 means that the atomic counter would need a lock,
+// which defeats the purpose of the lock-free ring buffer.
+_Static_assert(RING_BUF_CTR_LOCK_FREE != 0,
+               "RingBufCtr is never lock-free on this target");
+
+// ATOMIC_*_LOCK_FREE == 1 is reported by compilers for CPUs without the
+// atomic read-modify-write instructions (e.g., ARMv6-M), where the plain
+// loads and stores used here are still single instructions up to the
+// native word size. A 64-bit counter, however, is only acceptable when
+// it is "always" lock-free (64-bit CPUs).
+_Static_assert((RING_BUF_CTR_SIZE < 8U) || (RING_BUF_CTR_LOCK_FREE == 2),
+               "64-bit RingBufCtr requires a 64-bit CPU");
 
 //! Ring buffer element type
 //
@@ -66,16 +115,51 @@ typedef uint16_t RingBufCtr;
 //
 typedef uint8_t RingBufElement;
 
+//! Optional cache-line padding of the ::RingBuf struct
+//
+// @details
+// On multi-core hosts, the head (written by the producer) and the tail
+// (written by the consumer) in the same cache line cause "false sharing",
+// where the cache line bounces between the cores on every put/get.
+// Defining RING_BUF_CACHE_LINE (e.g., `-DRING_BUF_CACHE_LINE=64`) places
+// the head and tail in separate cache lines, away from the read-only
+// buf/end members. This is not needed for single-core MCUs without caches.
+//
+// @note
+// The padded ::RingBuf struct is over-aligned, so RingBuf objects on
+// the heap must be allocated with aligned_alloc().
+//
+#ifdef RING_BUF_CACHE_LINE
+#define RING_BUF_ALIGN _Alignas(RING_BUF_CACHE_LINE)
+#else
+#define RING_BUF_ALIGN
+#endif
+
+//! Optional observer snapshots of the ::RingBuf (RingBuf_snapshot())
+//
+// @details
+// Defining RING_BUF_SNAPSHOT (e.g., `-DRING_BUF_SNAPSHOT`) provides
+// RingBuf_snapshot() for a third (observer) thread. This adds the `seq`
+// counter to the ::RingBuf struct, which the consumer advances (as a
+// seqlock writer) every time the tail wraps around. Without it, the
+// ::RingBuf layout and the cost of the tail wrap-around are unchanged.
+//
+
 //! Ring buffer struct
 typedef struct {
     RingBufElement *buf; //!< pointer to the start of the ring buffer
     RingBufCtr end;      //!< index of the end of the ring buffer
 
     //! atomic index to where next element will be inserted
-    _Atomic(RingBufCtr) head;
+    RING_BUF_ALIGN _Atomic(RingBufCtr) head;
 
     //! atomic index to where next element will be removed
-    _Atomic(RingBufCtr) tail;
+    RING_BUF_ALIGN _Atomic(RingBufCtr) tail;
+
+#ifdef RING_BUF_SNAPSHOT
+    //! sequence of the tail wrap-arounds (seqlock for RingBuf_snapshot())
+    _Atomic(uint32_t) seq;
+#endif
 } RingBuf;
 
 void RingBuf_ctor(RingBuf * const me,
@@ -83,6 +167,10 @@ void RingBuf_ctor(RingBuf * const me,
 RingBufCtr RingBuf_num_free(RingBuf * const me);
 bool RingBuf_put(RingBuf * const me, RingBufElement const el);
 bool RingBuf_get(RingBuf * const me, RingBufElement *pel);
+RingBufCtr RingBuf_put_n(RingBuf * const me,
+                         RingBufElement const els[], RingBufCtr n);
+RingBufCtr RingBuf_get_n(RingBuf * const me,
+                         RingBufElement els[], RingBufCtr n);
 
 //! Ring buffer callback function for RingBuf_process_all()
 //
@@ -94,4 +182,156 @@ typedef void (*RingBufHandler)(RingBufElement const el);
 
 void RingBuf_process_all(RingBuf * const me, RingBufHandler handler);
 
+//! Read-only iterator over the elements in the ring buffer (consumer)
+//
+// @details
+// RingBufIter_ctor() takes the range [tail, head) at the time of the
+// call, and RingBufIter_next() returns the elements in that range from
+// the oldest, without removing them. Like RingBuf_peek_n(), it can be
+// used only by the consumer (or when the consumer is not running).
+//
+typedef struct {
+    RingBuf const *rb; //!< the ring buffer
+    RingBufCtr pos;    //!< index of the next element
+    RingBufCtr head;   //!< end of the range (head at the ctor)
+} RingBufIter;
+
+RingBufCtr RingBuf_peek_n(RingBuf * const me,
+                          RingBufElement els[], RingBufCtr n);
+void RingBufIter_ctor(RingBufIter * const me, RingBuf * const rb);
+bool RingBufIter_next(RingBufIter * const me, RingBufElement *pel);
+
+#ifdef RING_BUF_SNAPSHOT
+//! Validated snapshot of the ring buffer for a third (observer) thread
+//
+// @details
+// RingBuf_snapshot() copies up to `n` of the oldest elements without
+// writing to the ring buffer, so the single-producer/single-consumer
+// operation is not disturbed. The copy is validated afterwards against
+// the consumer's position (the tail and the number of its wrap-arounds,
+// read consistently with the `seq` seqlock): the elements that the
+// consumer removed (and the producer could overwrite) during the copy
+// are discarded, so the returned elements are exactly those that were
+// still in the ring buffer at the end of the snapshot.
+//
+// @note
+// The number of the consumer's wrap-arounds during one snapshot is known
+// modulo 2^31 (the `seq` counter can wrap around), which is exact unless
+// the consumer laps the ring buffer 2^31 times during a single copy.
+//
+RingBufCtr RingBuf_snapshot(RingBuf * const me,
+                            RingBufElement els[], RingBufCtr n);
+#endif // RING_BUF_SNAPSHOT
+
+//! Statically allocated and initialized ring buffer
+//
+// @details
+// Defines the storage `name_##_sto[len_]` and the ring buffer `name_`,
+// both initialized at compile time (no RingBuf_ctor() call at startup),
+// together with the inline functions `name_##_put(el)`, `name_##_get(pel)`,
+// and `name_##_num_free()` that use the constant length `len_`. This
+// allows the compiler to strength-reduce the wrap-around compares (e.g.,
+// to a mask for a power-of-2 length). The ring buffer `name_` remains
+// an ordinary ::RingBuf, so it can be used with all RingBuf_...()
+// functions as well, e.g., `RingBuf_process_all(&name_, handler)`.
+//
+// @usage
+// @code
+// RING_BUF_DEFINE(uart_rx, 64U); // at file scope
+// ...
+// uart_rx_put(ch);       // e.g., in the ISR
+// ...
+// if (uart_rx_get(&ch)) { // e.g., in the thread
+// @endcode
+//
+#define RING_BUF_DEFINE(name_, len_) \
+    _Static_assert(((len_) >= 2U) \
+                   && ((len_) <= (RingBufCtr)~(RingBufCtr)0), \
+                   "RING_BUF_DEFINE length out of range"); \
+    static RingBufElement name_##_sto[(len_)]; \
+    static RingBuf name_ = { .buf = &name_##_sto[0], \
+                             .end = (RingBufCtr)(len_) }; \
+    static inline bool name_##_put(RingBufElement const el) { \
+        return RingBuf_put_fixed_(&name_, (RingBufCtr)(len_), el); \
+    } \
+    static inline bool name_##_get(RingBufElement *pel) { \
+        return RingBuf_get_fixed_(&name_, (RingBufCtr)(len_), pel); \
+    } \
+    static inline RingBufCtr name_##_num_free(void) { \
+        return RingBuf_num_free_fixed_(&name_, (RingBufCtr)(len_)); \
+    } \
+    typedef int name_##_dummy_ // to require the semicolon after the macro
+
+// tail store by the consumer after the tail wrapped around, which also
+// advances the wrap-around sequence for RingBuf_snapshot() (seqlock writer)
+static inline void RingBuf_wrap_tail_(RingBuf * const me,
+    RingBufCtr const tail)
+{
+#ifdef RING_BUF_SNAPSHOT
+    uint32_t const seq = atomic_load_explicit(&me->seq, memory_order_relaxed);
+    atomic_store_explicit(&me->seq, seq + 1U, memory_order_relaxed); // odd
+    // the release of the tail also publishes the odd seq to the observer
+    // that acquires the tail, so no fence is needed
+    atomic_store_explicit(&me->tail, tail, memory_order_release);
+    atomic_store_explicit(&me->seq, seq + 2U, memory_order_release); // even
+#else
+    atomic_store_explicit(&me->tail, tail, memory_order_release);
+#endif
+}
+// tail store by the consumer, moving the tail from 'old' to 'tail'
+static inline void RingBuf_set_tail_(RingBuf * const me,
+    RingBufCtr const old, RingBufCtr const tail)
+{
+    if (tail < old) { // wrapped around?
+        RingBuf_wrap_tail_(me, tail);
+    }
+    else {
+        atomic_store_explicit(&me->tail, tail, memory_order_release);
+    }
+}
+
+// helpers for RING_BUF_DEFINE() (the same algorithm as in ring_buf.c,
+// but with the ring buffer end as a parameter, which is a constant there)
+static inline bool RingBuf_put_fixed_(RingBuf * const me,
+    RingBufCtr const end, RingBufElement const el)
+{
+    RingBufCtr const head =
+        atomic_load_explicit(&me->head, memory_order_relaxed);
+    RingBufCtr const next = (head + 1U == end) ? 0U : (RingBufCtr)(head + 1U);
+    if (next != atomic_load_explicit(&me->tail, memory_order_acquire)) {
+        me->buf[head] = el;
+        atomic_store_explicit(&me->head, next, memory_order_release);
+        return true;
+    }
+    return false; // buffer full
+}
+static inline bool RingBuf_get_fixed_(RingBuf * const me,
+    RingBufCtr const end, RingBufElement *pel)
+{
+    RingBufCtr const tail =
+        atomic_load_explicit(&me->tail, memory_order_relaxed);
+    if (atomic_load_explicit(&me->head, memory_order_acquire) != tail) {
+        *pel = me->buf[tail];
+        if (tail + 1U == end) {
+            RingBuf_wrap_tail_(me, 0U);
+        }
+        else {
+            atomic_store_explicit(&me->tail, (RingBufCtr)(tail + 1U),
+                                  memory_order_release);
+        }
+        return true;
+    }
+    return false; // buffer empty
+}
+static inline RingBufCtr RingBuf_num_free_fixed_(RingBuf * const me,
+    RingBufCtr const end)
+{
+    RingBufCtr const head =
+        atomic_load_explicit(&me->head, memory_order_acquire);
+    RingBufCtr const tail =
+        atomic_load_explicit(&me->tail, memory_order_relaxed);
+    return (head < tail) ? (RingBufCtr)(tail - head - 1U)
+                         : (RingBufCtr)(end + tail - head - 1U);
+}
+
 #endif // RING_BUF_H
@@ -0,0 +1,91 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf_dma.h"
+
+//............................................................................
+void RingBufDma_ctor(RingBufDma * const me,
+                     RingBufElement sto[], RingBufCtr sto_len,
+                     RingBufDmaNdtr const *ndtr)
+{
+    RingBuf_ctor(&me->rb, sto, sto_len);
+    me->ndtr = ndtr;
+    me->overruns = 0U;
+}
+//............................................................................
+RingBufCtr RingBufDma_sync(RingBufDma * const me) {
+    RingBufCtr const end = me->rb.end;
+#ifdef Q_HOST
+    // the simulated DMA engine publishes the elements with the release
+    // store of the remaining count
+    RingBufCtr const remaining = (RingBufCtr)atomic_load_explicit(
+        me->ndtr, memory_order_acquire);
+#else
+    RingBufCtr const remaining = (RingBufCtr)*me->ndtr;
+
+    // the DMA has written the elements before it decremented the count
+    // (no data cache on Cortex-M0+); the fence keeps the compiler from
+    // moving the accesses to the elements before the register read
+    atomic_thread_fence(memory_order_acquire);
+#endif
+
+    RingBufCtr const head = ((remaining == 0U) || (remaining >= end))
+                            ? 0U
+                            : (RingBufCtr)(end - remaining);
+    RingBufCtr const old_head =
+        atomic_load_explicit(&me->rb.head, memory_order_relaxed);
+    RingBufCtr const tail =
+        atomic_load_explicit(&me->rb.tail, memory_order_acquire);
+
+    RingBufCtr const n_new = (head >= old_head)
+                             ? (RingBufCtr)(head - old_head)
+                             : (RingBufCtr)(end + head - old_head);
+    RingBufCtr const used = (old_head >= tail)
+                            ? (RingBufCtr)(old_head - tail)
+                            : (RingBufCtr)(end + old_head - tail);
+
+    // the DMA has overwritten unread elements if more arrived than
+    // fit into the free space (capacity is end - 1, as for RingBuf_put())
+    if ((uint32_t)used + n_new > (uint32_t)end - 1U) {
+        ++me->overruns;
+    }
+    atomic_store_explicit(&me->rb.head, head, memory_order_release);
+    return n_new;
+}
+//............................................................................
+void RingBufDma_flush(RingBufDma * const me) {
+    // discard all received elements (e.g., to recover from an overrun)
+    RingBuf_set_tail_(&me->rb,
+        atomic_load_explicit(&me->rb.tail, memory_order_relaxed),
+        atomic_load_explicit(&me->rb.head, memory_order_acquire));
+}
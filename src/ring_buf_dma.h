@@ -0,0 +1,88 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_BUF_DMA_H
+#define RING_BUF_DMA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Ring buffer filled by a circular DMA channel (e.g., UART RX)
+//
+// @details
+// The DMA channel writes the ring buffer storage in circular mode, so
+// the producer is the hardware and no RingBuf_put() calls are made.
+// Instead, RingBufDma_sync() derives the ring buffer head from the
+// DMA "remaining count" register (e.g., CNDTR on STM32), which counts
+// down from the ring length to 1 and then reloads:
+//
+//     head = (len - remaining) % len
+//
+// The consumer uses the embedded `rb` ring buffer as usual, with
+// RingBuf_get(), RingBuf_process_all(), and RingBuf_num_free().
+// On the target, the DMA channel is set up in circular mode with the
+// ring storage as the memory address and the ring length as the count,
+// and RingBufDma_ctor() gets the address of the count register, e.g.,
+// `&DMA1_Channel1->CNDTR`.
+//
+// @attention
+// RingBufDma_sync() is the only writer of the head, so it must be called
+// from one context only: either the consumer itself (before draining the
+// ring), or the DMA half/full-transfer and UART idle-line interrupts.
+// The DMA does not stop when the ring is full, so the overrun detection
+// requires RingBufDma_sync() to run at least twice per lap of the DMA
+// through the ring (the half- and full-transfer interrupts do that).
+//
+//! DMA "remaining count" register: the hardware register on the target,
+//! or an atomic variable written by the simulated DMA engine on the host
+#ifdef Q_HOST
+typedef _Atomic(uint32_t) RingBufDmaNdtr;
+#else
+typedef uint32_t volatile RingBufDmaNdtr;
+#endif
+
+typedef struct {
+    RingBuf rb; //!< the ring buffer (head owned by RingBufDma_sync())
+
+    //! DMA "remaining count" register (counts down from rb.end to 1)
+    RingBufDmaNdtr const *ndtr;
+
+    uint32_t overruns; //!< number of overruns detected by RingBufDma_sync()
+} RingBufDma;
+
+void RingBufDma_ctor(RingBufDma * const me,
+                     RingBufElement sto[], RingBufCtr sto_len,
+                     RingBufDmaNdtr const *ndtr);
+RingBufCtr RingBufDma_sync(RingBufDma * const me);
+void RingBufDma_flush(RingBufDma * const me);
+
+#endif // RING_BUF_DMA_H
@@ -0,0 +1,211 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#define _GNU_SOURCE // for MAP_ANONYMOUS, MAP_HUGETLB, MADV_HUGEPAGE
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buf_host.h"
+
+#ifdef _WIN32
+#include <stdlib.h> // for malloc()/free()
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+#define CHUNK_SIZE (2UL * 1024UL * 1024UL) // 2MB huge page
+#define SMALL_PAGE (4UL * 1024UL)         // ordinary (small) page
+
+// storage offset after the RingBufPersist header in the persistent file
+#define PERSIST_STO_OFFSET \
+    ((sizeof(RingBufPersist) + 63U) & ~(size_t)63U)
+
+static size_t sto_size(RingBufCtr sto_len, uint8_t pages);
+static void *sto_map(size_t size, uint8_t pages);
+static void sto_bind(void *sto, size_t size, int numa_node);
+static void sto_prefault(void *sto, size_t size);
+
+//............................................................................
+bool RingBuf_host_ctor(RingBuf * const me, RingBufCtr sto_len,
+                       RingBufHostCfg const * const cfg)
+{
+    size_t const size = sto_size(sto_len, cfg->pages);
+    void *sto = sto_map(size, cfg->pages);
+    if (sto == (void *)0) {
+        return false;
+    }
+    sto_bind(sto, size, cfg->numa_node);
+    if (cfg->prefault) {
+        sto_prefault(sto, size);
+    }
+    RingBuf_ctor(me, (RingBufElement *)sto, sto_len);
+    return true;
+}
+//............................................................................
+void RingBuf_host_xtor(RingBuf * const me,
+                       RingBufHostCfg const * const cfg)
+{
+#ifdef _WIN32
+    (void)cfg;
+    free(me->buf);
+#else
+    munmap(me->buf, sto_size(me->end, cfg->pages));
+#endif
+    me->buf = (RingBufElement *)0;
+    me->end = 0U;
+}
+
+//............................................................................
+RingBufPersist *RingBuf_host_persist(char const *path, RingBufCtr sto_len,
+                                     bool *recovered)
+{
+    *recovered = false;
+#ifdef _WIN32
+    (void)path;
+    (void)sto_len;
+    return (RingBufPersist *)0; // not supported
+#else
+    size_t const size = PERSIST_STO_OFFSET
+                        + (size_t)sto_len * sizeof(RingBufElement);
+    int const fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return (RingBufPersist *)0;
+    }
+    // a new (or shorter) file is extended with zeros (invalid header)
+    if (ftruncate(fd, (off_t)size) != 0) {
+        (void)close(fd);
+        return (RingBufPersist *)0;
+    }
+    void *p = mmap((void *)0, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED, fd, 0);
+    (void)close(fd); // the mapping keeps the file open
+    if (p == MAP_FAILED) {
+        return (RingBufPersist *)0;
+    }
+    RingBufPersist * const me = (RingBufPersist *)p;
+    *recovered = RingBufPersist_init(me,
+        (RingBufElement *)((uint8_t *)p + PERSIST_STO_OFFSET), sto_len);
+    return me;
+#endif
+}
+//............................................................................
+void RingBuf_host_persist_close(RingBufPersist * const me) {
+#ifdef _WIN32
+    (void)me;
+#else
+    size_t const size = PERSIST_STO_OFFSET
+                        + (size_t)me->len * sizeof(RingBufElement);
+    (void)msync(me, size, MS_SYNC); // also survive the crash of the OS
+    (void)munmap(me, size);
+#endif
+}
+
+//............................................................................
+static size_t sto_size(RingBufCtr sto_len, uint8_t pages) {
+    size_t const size = (size_t)sto_len * sizeof(RingBufElement);
+    // huge pages (also the THP fallback of HUGETLB) need the 2MB chunks,
+    // the ordinary pages only the 4KB ones
+    size_t const chunk = (pages != RING_BUF_PAGES_DEFAULT)
+                         ? CHUNK_SIZE : SMALL_PAGE;
+    return (size + chunk - 1U) & ~(chunk - 1U);
+}
+//............................................................................
+static void *sto_map(size_t size, uint8_t pages) {
+#ifdef _WIN32
+    (void)pages;
+    return malloc(size);
+#else
+    void *sto;
+#ifdef MAP_HUGETLB
+    if (pages == RING_BUF_PAGES_HUGETLB) {
+        sto = mmap((void *)0, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (sto != MAP_FAILED) {
+            return sto;
+        }
+        pages = RING_BUF_PAGES_THP; // no reserved huge pages, try THP
+    }
+#endif
+    sto = mmap((void *)0, size, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (sto == MAP_FAILED) {
+        return (void *)0;
+    }
+#ifdef MADV_HUGEPAGE
+    if (pages != RING_BUF_PAGES_DEFAULT) {
+        (void)madvise(sto, size, MADV_HUGEPAGE); // just advice
+    }
+#endif
+    return sto;
+#endif // _WIN32
+}
+//............................................................................
+static void sto_bind(void *sto, size_t size, int numa_node) {
+#if defined(__linux__) && defined(SYS_mbind) && defined(SYS_getcpu)
+    if (numa_node == RING_BUF_NUMA_LOCAL) {
+        unsigned cpu;
+        unsigned node;
+        if (syscall(SYS_getcpu, &cpu, &node, (void *)0) != 0) {
+            return; // node unknown, leave the default policy
+        }
+        numa_node = (int)node;
+    }
+    if ((numa_node >= 0) && (numa_node < 64)) {
+        unsigned long nodemask = 1UL << numa_node;
+        // MPOL_PREFERRED is a hint (falls back to other nodes when the
+        // node is full); maxnode is the number of nodemask bits + 1
+        (void)syscall(SYS_mbind, sto, size, MPOL_PREFERRED, &nodemask,
+                      sizeof(nodemask) * 8U + 1U, MPOL_MF_MOVE);
+    }
+#else
+    (void)sto;
+    (void)size;
+    (void)numa_node;
+#endif
+}
+//............................................................................
+static void sto_prefault(void *sto, size_t size) {
+    // touch every (small) page, so that no page faults occur later
+    // in the producer and consumer
+    uint8_t volatile *p = (uint8_t volatile *)sto;
+    for (size_t i = 0U; i < size; i += SMALL_PAGE) {
+        p[i] = 0U;
+    }
+}
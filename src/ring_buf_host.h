@@ -0,0 +1,86 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_BUF_HOST_H
+#define RING_BUF_HOST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_buf_persist.h"
+
+//! Ring buffer storage allocation on host computers
+//
+// @details
+// The ring buffer storage allocated by RingBuf_host_ctor() is mapped
+// in chunks of 2MB (the typical size of a "huge page") when huge pages
+// are requested, and in 4KB pages otherwise, so that large ring buffers
+// can be backed by huge pages and placed on a selected NUMA node. Both
+// these features are only hints. When they are not available, the ring
+// buffer falls back to the ordinary pages and memory policy.
+// RingBuf_host_xtor() must be called with the same configuration.
+//
+typedef struct {
+    uint8_t pages;  //!< kind of pages (see ::RingBufPages)
+    bool prefault;  //!< touch all pages before returning?
+    int numa_node;  //!< preferred NUMA node of the storage, or RING_BUF_NUMA_*
+} RingBufHostCfg;
+
+//! Kinds of pages for RingBufHostCfg.pages
+enum RingBufPages {
+    RING_BUF_PAGES_DEFAULT, //!< ordinary pages (default policy)
+    RING_BUF_PAGES_THP,     //!< transparent huge pages (madvise advice)
+    RING_BUF_PAGES_HUGETLB, //!< reserved huge pages, fallback to THP
+};
+
+#define RING_BUF_NUMA_ANY   (-1) //!< no NUMA binding
+#define RING_BUF_NUMA_LOCAL (-2) //!< NUMA node of the calling thread
+
+bool RingBuf_host_ctor(RingBuf * const me, RingBufCtr sto_len,
+                       RingBufHostCfg const * const cfg);
+void RingBuf_host_xtor(RingBuf * const me,
+                       RingBufHostCfg const * const cfg);
+
+//! Persistent ring buffer in a memory-mapped file (see ::RingBufPersist)
+//
+// @details
+// Maps (and creates, if needed) the file `path` with the ::RingBufPersist
+// header followed by the storage of `sto_len` elements, shared with the
+// file, so that the contents survive the crash of the process (but not
+// an OS crash or power loss, see ::RingBufPersist). Sets
+// `*recovered` when the previous contents of the file have been
+// recovered. Returns NULL when the file cannot be mapped.
+//
+RingBufPersist *RingBuf_host_persist(char const *path, RingBufCtr sto_len,
+                                     bool *recovered);
+void RingBuf_host_persist_close(RingBufPersist * const me);
+
+#endif // RING_BUF_HOST_H
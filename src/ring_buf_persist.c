@@ -0,0 +1,98 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf_persist.h"
+
+// geometry of the persistent ring buffer, which must match after restart
+#define GEOM ((uint32_t)sizeof(RingBufElement) \
+              | ((uint32_t)sizeof(RingBufCtr) << 8) \
+              | ((uint32_t)sizeof(RingBuf) << 16))
+
+static uint32_t header_check(RingBufPersist const * const me);
+
+//............................................................................
+// Initialize the persistent ring buffer at the (re)start of the program.
+// Returns true when the previous contents have been recovered, or false
+// when the ring buffer starts empty (e.g., cold start, corrupted header).
+bool RingBufPersist_init(RingBufPersist * const me,
+                         RingBufElement sto[], RingBufCtr sto_len)
+{
+    bool valid = (me->magic == RING_BUF_PERSIST_MAGIC)
+                 && (me->len == sto_len)
+                 && (me->geom == GEOM)
+                 && (me->rb.end == sto_len)
+                 && (me->check == header_check(me));
+    if (valid) {
+        // the indices change with every put/get, so they are not covered
+        // by the check (which would cost the hot path), only validated
+        RingBufCtr const head =
+            atomic_load_explicit(&me->rb.head, memory_order_relaxed);
+        RingBufCtr const tail =
+            atomic_load_explicit(&me->rb.tail, memory_order_relaxed);
+        valid = (head < sto_len) && (tail < sto_len);
+    }
+
+    // invalidate the header while updating it
+    me->magic = 0U;
+    atomic_thread_fence(memory_order_release);
+    if (valid) {
+        // the storage address can differ after restart (e.g., mmap)
+        me->rb.buf = &sto[0];
+        ++me->n_recovered;
+    }
+    else {
+        RingBuf_ctor(&me->rb, sto, sto_len);
+        me->len   = sto_len;
+        me->geom  = GEOM;
+        me->n_recovered = 0U;
+    }
+    me->check = header_check(me);
+    atomic_thread_fence(memory_order_release);
+    me->magic = RING_BUF_PERSIST_MAGIC;
+    return valid;
+}
+
+//............................................................................
+static uint32_t header_check(RingBufPersist const * const me) {
+    // FNV-1a of the header words (written only at the initialization);
+    // n_recovered is covered, so the check changes at every recovery
+    uint32_t x = 0x811C9DC5U;
+    uint32_t const w[] = {
+        RING_BUF_PERSIST_MAGIC, me->len, me->geom, me->n_recovered,
+        (uint32_t)me->rb.end
+    };
+    for (unsigned i = 0U; i < sizeof(w)/sizeof(w[0]); ++i) {
+        x = (x ^ w[i]) * 0x01000193U;
+    }
+    return x;
+}
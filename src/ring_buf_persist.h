@@ -0,0 +1,90 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_BUF_PERSIST_H
+#define RING_BUF_PERSIST_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Placement of the persistent ring buffer in the no-init RAM (MCUs)
+//
+// @details
+// The `.noinit` section is not cleared or initialized by the startup
+// code, so its contents survive a reset (watchdog, fault, debugger).
+// The linker script must provide it (see nucleo-c031c6.ld).
+//
+#ifndef RING_BUF_NOINIT
+#define RING_BUF_NOINIT __attribute__((section(".noinit")))
+#endif
+
+//! Magic number of a valid ::RingBufPersist header
+#define RING_BUF_PERSIST_MAGIC 0x4C465242U // "LFRB"
+
+//! Persistent ring buffer that survives a crash or reset
+//
+// @details
+// The control block and the storage are placed in memory that survives
+// the restart of the program: the no-init RAM on MCUs (RING_BUF_NOINIT),
+// or a memory-mapped file on hosts (see RingBuf_host_persist() in
+// ring_buf_host.h). At the restart, RingBufPersist_init() validates the
+// header (magic, geometry, and the checksum of the header words, which
+// include the number of recoveries) and the range of the head/tail
+// indices, and either recovers the ring buffer with the elements that
+// survived, or starts with an empty ring buffer.
+//
+// The producer and consumer use the embedded `rb` with the ordinary
+// RingBuf_put()/RingBuf_get(), so the hot path is not changed. The
+// head is published (release) only after the element is written, so
+// a crash in the middle of RingBuf_put() loses only that element.
+//
+// @attention
+// Only a crash of the process (host) or a reset (MCU) is covered, where
+// the memory keeps all the completed stores. The elements are not guarded
+// by a checksum. After an OS crash or power loss, the pages of the
+// memory-mapped file reach the disk in any order (msync() is called only
+// in RingBuf_host_persist_close()), so the recovered head can refer to
+// elements that were never written back, which is not detected.
+//
+typedef struct {
+    uint32_t magic;  //!< RING_BUF_PERSIST_MAGIC when valid
+    uint32_t len;    //!< length of the storage [elements]
+    uint32_t geom;   //!< element and counter sizes
+    uint32_t check;  //!< checksum of magic, len, geom, n_recovered, rb.end
+    uint32_t n_recovered; //!< number of the successful recoveries
+    RingBuf rb;      //!< the ring buffer (buf pointer is re-set at init)
+} RingBufPersist;
+
+bool RingBufPersist_init(RingBufPersist * const me,
+                         RingBufElement sto[], RingBufCtr sto_len);
+
+#endif // RING_BUF_PERSIST_H
@@ -0,0 +1,127 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf_timed.h"
+
+//............................................................................
+void RingBufTimed_ctor(RingBufTimed * const me,
+                       RingBufElement sto[], RingBufTime ts_sto[],
+                       RingBufCtr sto_len, RingBufClock clock)
+{
+    RingBuf_ctor(&me->rb, sto, sto_len);
+    me->ts    = &ts_sto[0];
+    me->clock = clock;
+}
+//............................................................................
+bool RingBufTimed_put(RingBufTimed * const me, RingBufElement const el) {
+    RingBufCtr const head =
+        atomic_load_explicit(&me->rb.head, memory_order_relaxed);
+    RingBufCtr next = head + 1U;
+    if (next == me->rb.end) {
+        next = 0U;
+    }
+    RingBufCtr tail = atomic_load_explicit(&me->rb.tail, memory_order_acquire);
+    if (next != tail) { // buffer NOT full?
+        me->rb.buf[head] = el;
+        me->ts[head] = (*me->clock)();
+        // the element and its time stamp are released together
+        atomic_store_explicit(&me->rb.head, next, memory_order_release);
+        return true;
+    }
+    else {
+        return false; // buffer full
+    }
+}
+//............................................................................
+bool RingBufTimed_get(RingBufTimed * const me,
+                      RingBufElement *pel, RingBufTime *pts)
+{
+    RingBufCtr tail = atomic_load_explicit(&me->rb.tail, memory_order_relaxed);
+    RingBufCtr head = atomic_load_explicit(&me->rb.head, memory_order_acquire);
+    if (head != tail) { // buffer NOT empty?
+        *pel = me->rb.buf[tail];
+        *pts = me->ts[tail];
+        ++tail;
+        if (tail == me->rb.end) {
+            RingBuf_wrap_tail_(&me->rb, 0U);
+        }
+        else {
+            atomic_store_explicit(&me->rb.tail, tail, memory_order_release);
+        }
+        return true;
+    }
+    else {
+        return false; // buffer empty
+    }
+}
+//............................................................................
+// Discard all elements older than 'max_age' (consumer side).
+// Returns the number of discarded elements.
+RingBufCtr RingBufTimed_expire(RingBufTimed * const me,
+                               RingBufTime const max_age)
+{
+    RingBufCtr const tail =
+        atomic_load_explicit(&me->rb.tail, memory_order_relaxed);
+    RingBufCtr const head =
+        atomic_load_explicit(&me->rb.head, memory_order_acquire);
+    RingBufCtr const end = me->rb.end;
+    RingBufTime const now = (*me->clock)();
+
+    // binary search for the first element not older than max_age among
+    // the 'used' elements in the logical order from the tail
+    RingBufCtr lo = 0U;
+    RingBufCtr hi = (head >= tail)
+                    ? (RingBufCtr)(head - tail)
+                    : (RingBufCtr)(end + head - tail);
+    while (lo < hi) {
+        RingBufCtr const mid = lo + (RingBufCtr)((hi - lo) / 2U);
+        RingBufCtr idx = tail + mid;
+        if ((idx >= end) || (idx < tail)) { // wrapped (or overflowed)?
+            idx = (RingBufCtr)(idx - end);
+        }
+        if ((RingBufTime)(now - me->ts[idx]) > max_age) { // expired?
+            lo = mid + 1U;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    if (lo != 0U) { // any expired elements?
+        RingBufCtr new_tail = tail + lo;
+        if ((new_tail >= end) || (new_tail < tail)) {
+            new_tail = (RingBufCtr)(new_tail - end);
+        }
+        RingBuf_set_tail_(&me->rb, tail, new_tail);
+    }
+    return lo;
+}
@@ -0,0 +1,78 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_BUF_TIMED_H
+#define RING_BUF_TIMED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Time stamp type of ::RingBufTimed (e.g., TSC on hosts, ticks on MCUs)
+//
+// @details
+// The time stamps can wrap around, because only the differences (ages)
+// are used, which must be below the half of the RingBufTime range.
+//
+#ifndef RING_BUF_TIME_TYPE
+#define RING_BUF_TIME_TYPE uint32_t
+#endif
+typedef RING_BUF_TIME_TYPE RingBufTime;
+
+//! Clock function of ::RingBufTimed (called by the producer and consumer)
+typedef RingBufTime (*RingBufClock)(void);
+
+//! Ring buffer with time-stamped elements and age-based expiry
+//
+// @details
+// RingBufTimed_put() stamps every element with the current time from
+// the pluggable clock into a parallel array of time stamps. Because the
+// single producer stamps the elements in order, the ages of the elements
+// decrease from the tail to the head. RingBufTimed_expire() can then find
+// the first element that is not too old by binary search and discard all
+// older elements by advancing the tail only once.
+//
+typedef struct {
+    RingBuf rb;         //!< the ring buffer of elements
+    RingBufTime *ts;    //!< time stamps, parallel to the elements
+    RingBufClock clock; //!< clock for the time stamps
+} RingBufTimed;
+
+void RingBufTimed_ctor(RingBufTimed * const me,
+                       RingBufElement sto[], RingBufTime ts_sto[],
+                       RingBufCtr sto_len, RingBufClock clock);
+bool RingBufTimed_put(RingBufTimed * const me, RingBufElement const el);
+bool RingBufTimed_get(RingBufTimed * const me,
+                      RingBufElement *pel, RingBufTime *pts);
+RingBufCtr RingBufTimed_expire(RingBufTimed * const me,
+                               RingBufTime const max_age);
+
+#endif // RING_BUF_TIMED_H
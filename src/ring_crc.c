@@ -0,0 +1,183 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "ring_crc.h"
+
+#if defined __SSE4_2__ && defined __x86_64__
+    #define CRC_SSE42
+    #include <nmmintrin.h>
+#elif defined __ARM_FEATURE_CRC32
+    #define CRC_ARMV8
+    #include <arm_acle.h>
+#endif
+
+_Static_assert(sizeof(RingBufElement) == 1U,
+               "ring_crc.c requires RingBufElement of one byte");
+
+// CRC-32C (reflected polynomial 0x82F63B78), 4 bits at a time
+static uint32_t const l_crc32c_tab[16] = {
+    0x00000000U, 0x105EC76FU, 0x20BD8EDEU, 0x30E349B1U,
+    0x417B1DBCU, 0x5125DAD3U, 0x61C69362U, 0x7198540DU,
+    0x82F63B78U, 0x92A8FC17U, 0xA24BB5A6U, 0xB21572C9U,
+    0xC38D26C4U, 0xD3D3E1ABU, 0xE330A81AU, 0xF36E6F75U
+};
+static uint32_t copy_crc32c(uint8_t *dst, uint8_t const *src, size_t n,
+                            uint32_t c);
+static uint16_t copy_crc16(uint8_t *dst, uint8_t const *src, size_t n,
+                           uint16_t c);
+static RingBufCtr drain(RingBuf * const me, uint8_t buf[], RingBufCtr n,
+                        uint32_t *crc, bool crc16);
+
+//............................................................................
+uint32_t RingCrc_crc32c(uint32_t crc, uint8_t const *p, size_t n) {
+    return ~copy_crc32c((uint8_t *)0, p, n, ~crc);
+}
+//............................................................................
+uint16_t RingCrc_crc16(uint16_t crc, uint8_t const *p, size_t n) {
+    return (uint16_t)~copy_crc16((uint8_t *)0, p, n, (uint16_t)~crc);
+}
+//............................................................................
+// Removes up to 'n' bytes into 'buf' (like RingBuf_get_n()) and updates
+// the CRC-32C in '*crc' with them. Returns the number of removed bytes.
+RingBufCtr RingBuf_get_n_crc32c(RingBuf * const me,
+                                uint8_t buf[], RingBufCtr n,
+                                uint32_t *crc)
+{
+    return drain(me, buf, n, crc, false);
+}
+//............................................................................
+// Removes up to 'n' bytes into 'buf' (like RingBuf_get_n()) and updates
+// the CRC-16 in '*crc' with them. Returns the number of removed bytes.
+RingBufCtr RingBuf_get_n_crc16(RingBuf * const me,
+                               uint8_t buf[], RingBufCtr n,
+                               uint16_t *crc)
+{
+    uint32_t c = *crc;
+    n = drain(me, buf, n, &c, true);
+    *crc = (uint16_t)c;
+    return n;
+}
+
+//............................................................................
+static RingBufCtr drain(RingBuf * const me, uint8_t buf[], RingBufCtr n,
+                        uint32_t *crc, bool crc16)
+{
+    RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
+    RingBufCtr n_used = (head >= tail)
+                        ? (RingBufCtr)(head - tail)
+                        : (RingBufCtr)(me->end + head - tail);
+    if (n > n_used) {
+        n = n_used;
+    }
+    // copy (and CRC) the 1 or 2 contiguous spans
+    RingBufCtr const n_end = (RingBufCtr)(me->end - tail); // up to the end
+    RingBufCtr const n1 = (n < n_end) ? n : n_end;
+    RingBufCtr const n2 = (RingBufCtr)(n - n1);
+    if (crc16) {
+        uint16_t c = (uint16_t)~*crc;
+        c = copy_crc16(&buf[0], &me->buf[tail], n1, c);
+        c = copy_crc16(&buf[n1], &me->buf[0], n2, c);
+        *crc = (uint16_t)~c;
+    }
+    else {
+        uint32_t c = ~*crc;
+        c = copy_crc32c(&buf[0], &me->buf[tail], n1, c);
+        c = copy_crc32c(&buf[n1], &me->buf[0], n2, c);
+        *crc = ~c;
+    }
+    RingBufCtr next = (n2 == 0U) ? (RingBufCtr)(tail + n1) : n2;
+    if (next == me->end) {
+        next = 0U;
+    }
+    RingBuf_set_tail_(me, tail, next);
+    return n;
+}
+
+//............................................................................
+// copies src[0..n) to dst (unless NULL) and updates the raw CRC-32C 'c'
+static uint32_t copy_crc32c(uint8_t *dst, uint8_t const *src, size_t n,
+                            uint32_t c)
+{
+    size_t i = 0U;
+#if defined CRC_SSE42
+    for (; i + 8U <= n; i += 8U) {
+        uint64_t w;
+        memcpy(&w, &src[i], 8U);
+        c = (uint32_t)_mm_crc32_u64(c, w);
+        if (dst != (uint8_t *)0) {
+            memcpy(&dst[i], &w, 8U);
+        }
+    }
+#elif defined CRC_ARMV8
+    for (; i + 4U <= n; i += 4U) {
+        uint32_t w;
+        memcpy(&w, &src[i], 4U);
+        c = __crc32cw(c, w);
+        if (dst != (uint8_t *)0) {
+            memcpy(&dst[i], &w, 4U);
+        }
+    }
+#endif
+    for (; i < n; ++i) { // the remaining bytes (or all without CRC insns)
+        uint8_t const b = src[i];
+        c ^= b;
+        c = (c >> 4) ^ l_crc32c_tab[c & 0xFU];
+        c = (c >> 4) ^ l_crc32c_tab[c & 0xFU];
+        if (dst != (uint8_t *)0) {
+            dst[i] = b;
+        }
+    }
+    return c;
+}
+//............................................................................
+// copies src[0..n) to dst (unless NULL) and updates the raw CRC-16 'c'
+static uint16_t copy_crc16(uint8_t *dst, uint8_t const *src, size_t n,
+                           uint16_t c)
+{
+    for (size_t i = 0U; i < n; ++i) {
+        uint8_t const b = src[i];
+        // CRC-16/X-25 (reflected polynomial 0x8408), a byte at a time
+        // without a table
+        uint8_t x = (uint8_t)(c ^ b);
+        x ^= (uint8_t)(x << 4);
+        c = (uint16_t)((c >> 8) ^ ((uint16_t)x << 8) ^ ((uint16_t)x << 3)
+                       ^ (x >> 4));
+        if (dst != (uint8_t *)0) {
+            dst[i] = b;
+        }
+    }
+    return c;
+}
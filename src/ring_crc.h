@@ -0,0 +1,64 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_CRC_H
+#define RING_CRC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buf.h"
+
+//! CRC computed while draining a byte ring buffer
+//
+// @details
+// RingBuf_get_n_crc32c() and RingBuf_get_n_crc16() work like
+// RingBuf_get_n(), but also update the CRC of the removed bytes in the
+// same pass, so every byte is touched only once. The CRC-32C (Castagnoli)
+// uses the SSE4.2 (e.g., -msse4.2) or ARMv8 CRC instructions, when
+// available, and a small (16-entry) table otherwise. The CRC-16 is the
+// HDLC frame check sequence (CRC-16/X-25) computed without a table.
+//
+// All CRC functions can be chained, starting with `crc = 0`, such as:
+// `crc = RingCrc_crc32c(RingCrc_crc32c(0U, p1, n1), p2, n2)`. They
+// require `RingBufElement` of one byte.
+//
+uint32_t RingCrc_crc32c(uint32_t crc, uint8_t const *p, size_t n);
+uint16_t RingCrc_crc16(uint16_t crc, uint8_t const *p, size_t n);
+
+RingBufCtr RingBuf_get_n_crc32c(RingBuf * const me,
+                                uint8_t buf[], RingBufCtr n,
+                                uint32_t *crc);
+RingBufCtr RingBuf_get_n_crc16(RingBuf * const me,
+                               uint8_t buf[], RingBufCtr n,
+                               uint16_t *crc);
+
+#endif // RING_CRC_H
@@ -0,0 +1,280 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "ring_frame.h"
+#include "ring_span.h"
+#include "ring_crc.h"
+
+#define HDLC_FLAG 0x7EU
+#define HDLC_ESC  0x7DU
+#define HDLC_XOR  0x20U
+
+// Writer.free after the frame did not fit into the ring buffer
+#define W_OVERFLOW ((RingBufCtr)~(RingBufCtr)0)
+
+// writer of the not yet published bytes of a frame (producer)
+typedef struct {
+    RingBuf *rb;     // the ring buffer
+    RingBufCtr head; // private head (published only at the end)
+    RingBufCtr free; // free space remaining [bytes]
+} Writer;
+
+static void w_init(Writer * const w, RingBuf * const rb);
+static void w_byte(Writer * const w, uint8_t const b);
+static void w_copy(Writer * const w, uint8_t const *p, size_t n);
+static void w_hdlc(Writer * const w, uint8_t const b);
+static size_t dec_hdlc(uint8_t *p, size_t n);
+static size_t dec_cobs(uint8_t *p, size_t n);
+
+//............................................................................
+// Writes the frame with the payload p[0..n) into the ring buffer (with a
+// single head update). Returns false (and writes nothing) when the
+// stuffed frame does not fit into the free space. Called by the producer.
+bool RingFrame_put(RingBuf * const me, uint8_t const kind,
+                   uint8_t const *p, size_t n)
+{
+    Writer w;
+    w_init(&w, me);
+    if (kind == RING_FRAME_HDLC) {
+        w_byte(&w, HDLC_FLAG);
+        size_t i = 0U;
+        while (i < n) {
+            size_t j = i; // find the end of the clean run p[i..j)
+            while ((j < n) && (p[j] != HDLC_FLAG) && (p[j] != HDLC_ESC)) {
+                ++j;
+            }
+            w_copy(&w, &p[i], j - i);
+            if (j < n) {
+                w_hdlc(&w, p[j]);
+                ++j;
+            }
+            i = j;
+        }
+        uint16_t const fcs = RingCrc_crc16(0U, p, n);
+        w_hdlc(&w, (uint8_t)fcs); // FCS (little endian)
+        w_hdlc(&w, (uint8_t)(fcs >> 8));
+        w_byte(&w, HDLC_FLAG);
+    }
+    else { // COBS
+        size_t i = 0U;
+        for (;;) {
+            // find the end of the block p[i..j) of up to 254 non-zero bytes
+            size_t const lim = (n - i < 254U) ? n : (i + 254U);
+            size_t j = i;
+            while ((j < lim) && (p[j] != 0U)) {
+                ++j;
+            }
+            w_byte(&w, (uint8_t)(j - i + 1U)); // code
+            w_copy(&w, &p[i], j - i);
+            if (j == n) {
+                break;
+            }
+            // skip the zero, unless the block ended at the maximum length
+            i = (j - i < 254U) ? (j + 1U) : j;
+        }
+        w_byte(&w, 0U); // delimiter
+    }
+    if (w.free == W_OVERFLOW) { // did not fit?
+        return false;
+    }
+    atomic_store_explicit(&me->head, w.head, memory_order_release);
+    return true;
+}
+
+//............................................................................
+void RingFrameDec_ctor(RingFrameDec * const me, uint8_t const kind,
+                       uint8_t buf[], size_t buf_len)
+{
+    me->kind     = kind;
+    me->buf      = buf;
+    me->buf_len  = buf_len;
+    me->n_frames = 0U;
+    me->n_errors = 0U;
+}
+//............................................................................
+// Decodes all complete frames in the ring buffer and calls the handler
+// for each of them. Returns the number of the decoded frames. Called by
+// the consumer.
+uint32_t RingFrameDec_process(RingFrameDec * const me, RingBuf * const rb,
+                              RingFrameHandler handler, void *ctx)
+{
+    uint8_t const delim = (me->kind == RING_FRAME_HDLC) ? HDLC_FLAG : 0U;
+    uint32_t n_frames = 0U;
+    for (;;) {
+        RingBufCtr tail =
+            atomic_load_explicit(&rb->tail, memory_order_relaxed);
+        RingBufCtr const pos = RingBuf_find(rb, delim);
+        if (pos == RING_BUF_NOT_FOUND) {
+            if (RingBuf_num_free(rb) == 0U) { // full without a delimiter?
+                RingBuf_set_tail_(rb, tail,
+                    atomic_load_explicit(&rb->head, memory_order_acquire));
+                ++me->n_errors;
+            }
+            break;
+        }
+        if (pos != 0U) { // not an empty frame (e.g., HDLC opening flag)?
+            uint8_t *p;
+            RingBufCtr const n_end = (RingBufCtr)(rb->end - tail);
+            if (pos <= n_end) { // contiguous? decode in place
+                p = &rb->buf[tail];
+            }
+            else if ((size_t)pos <= me->buf_len) { // copy the wrapped frame
+                p = me->buf;
+                memcpy(&p[0], &rb->buf[tail], n_end);
+                memcpy(&p[n_end], &rb->buf[0], (RingBufCtr)(pos - n_end));
+            }
+            else {
+                p = (uint8_t *)0;
+            }
+            size_t len = (size_t)~(size_t)0;
+            if (p != (uint8_t *)0) {
+                len = (me->kind == RING_FRAME_HDLC)
+                      ? dec_hdlc(p, pos)
+                      : dec_cobs(p, pos);
+            }
+            if (len != (size_t)~(size_t)0) {
+                (*handler)(p, len, ctx);
+                ++n_frames;
+            }
+            else {
+                ++me->n_errors;
+            }
+        }
+        // release the frame and its delimiter
+        RingBufCtr next = (RingBufCtr)(tail + pos + 1U);
+        if ((next >= rb->end) || (next < tail)) {
+            next = (RingBufCtr)(next - rb->end);
+        }
+        RingBuf_set_tail_(rb, tail, next);
+    }
+    me->n_frames += n_frames;
+    return n_frames;
+}
+
+//............................................................................
+static void w_init(Writer * const w, RingBuf * const rb) {
+    w->rb   = rb;
+    w->head = atomic_load_explicit(&rb->head, memory_order_relaxed);
+    w->free = RingBuf_num_free(rb);
+}
+//............................................................................
+// after the overflow, nothing more is written
+static void w_byte(Writer * const w, uint8_t const b) {
+    if ((w->free != 0U) && (w->free != W_OVERFLOW)) {
+        w->rb->buf[w->head] = b;
+        ++w->head;
+        if (w->head == w->rb->end) {
+            w->head = 0U;
+        }
+        --w->free;
+    }
+    else {
+        w->free = W_OVERFLOW;
+    }
+}
+//............................................................................
+static void w_copy(Writer * const w, uint8_t const *p, size_t n) {
+    if ((w->free == W_OVERFLOW) || (n > (size_t)w->free)) {
+        w->free = W_OVERFLOW;
+        return;
+    }
+    RingBufCtr const n_end = (RingBufCtr)(w->rb->end - w->head);
+    if (n < (size_t)n_end) { // no wrap-around?
+        memcpy(&w->rb->buf[w->head], p, n);
+        w->head = (RingBufCtr)(w->head + n);
+    }
+    else {
+        memcpy(&w->rb->buf[w->head], p, n_end);
+        memcpy(&w->rb->buf[0], &p[n_end], n - n_end);
+        w->head = (RingBufCtr)(n - n_end);
+    }
+    w->free = (RingBufCtr)(w->free - n);
+}
+//............................................................................
+static void w_hdlc(Writer * const w, uint8_t const b) {
+    if ((b == HDLC_FLAG) || (b == HDLC_ESC)) {
+        w_byte(w, HDLC_ESC);
+        w_byte(w, (uint8_t)(b ^ HDLC_XOR));
+    }
+    else {
+        w_byte(w, b);
+    }
+}
+//............................................................................
+// unstuffs p[0..n) in place and checks the FCS; returns the payload
+// length, or ~0 for a corrupted frame
+static size_t dec_hdlc(uint8_t *p, size_t n) {
+    // the bytes before the first escape stay where they are
+    uint8_t const * const esc = (uint8_t const *)memchr(p, HDLC_ESC, n);
+    size_t len = (esc != (uint8_t const *)0) ? (size_t)(esc - p) : n;
+    for (size_t i = len; i < n; ++i) {
+        uint8_t b = p[i];
+        if (b == HDLC_ESC) {
+            if (++i == n) {
+                return (size_t)~(size_t)0;
+            }
+            b = (uint8_t)(p[i] ^ HDLC_XOR);
+        }
+        p[len] = b;
+        ++len;
+    }
+    if (len < 2U) {
+        return (size_t)~(size_t)0;
+    }
+    len -= 2U;
+    uint16_t const fcs = (uint16_t)(p[len] | ((uint16_t)p[len + 1U] << 8));
+    return (RingCrc_crc16(0U, p, len) == fcs) ? len : (size_t)~(size_t)0;
+}
+//............................................................................
+// decodes the COBS frame p[0..n) in place; returns the payload length,
+// or ~0 for a corrupted frame
+static size_t dec_cobs(uint8_t *p, size_t n) {
+    size_t len = 0U;
+    size_t i = 0U;
+    while (i < n) {
+        uint8_t const code = p[i];
+        if ((code == 0U) || (i + code > n)) {
+            return (size_t)~(size_t)0;
+        }
+        memmove(&p[len], &p[i + 1U], (size_t)code - 1U);
+        len += (size_t)code - 1U;
+        i += code;
+        if ((code != 0xFFU) && (i < n)) {
+            p[len] = 0U;
+            ++len;
+        }
+    }
+    return len;
+}
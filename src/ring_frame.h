@@ -0,0 +1,82 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_FRAME_H
+#define RING_FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buf.h"
+
+//! Kinds of framing (byte stuffing) for ::RingFrameDec and RingFrame_put()
+enum RingFrameKind {
+    RING_FRAME_HDLC, //!< 0x7E flags, 0x7D escapes, CRC-16/X-25 FCS
+    RING_FRAME_COBS, //!< Consistent Overhead Byte Stuffing, 0x00 delimiter
+};
+
+//! Handler of the decoded frames (see RingFrameDec_process())
+typedef void (*RingFrameHandler)(uint8_t const *frame, size_t len,
+                                 void *ctx);
+
+//! Streaming frame decoder (consumer of the byte ::RingBuf)
+//
+// @details
+// RingFrameDec_process() locates the frame delimiters with RingBuf_find()
+// (see ring_span.h) and decodes every complete frame *in place*, in the
+// ring buffer storage owned by the consumer until the tail is moved.
+// The handler gets a pointer straight into the ring buffer, so no extra
+// buffer is needed. The HDLC payload is written back only from the first
+// escape on, and every COBS block is moved down by one byte (its code).
+// Only a frame that wraps around the end of the storage is first copied
+// into the decoder's `buf`.
+//
+// Frames that are corrupted (bad escape, COBS code, or HDLC FCS), or
+// longer than the ring buffer can hold, are dropped and counted in
+// `n_errors`.
+//
+typedef struct {
+    uint8_t kind;      //!< the kind of framing (see ::RingFrameKind)
+    uint8_t *buf;      //!< buffer for the wrapped-around frames
+    size_t buf_len;    //!< length of `buf` [bytes]
+    uint32_t n_frames; //!< number of the decoded frames
+    uint32_t n_errors; //!< number of the dropped frames
+} RingFrameDec;
+
+bool RingFrame_put(RingBuf * const me, uint8_t const kind,
+                   uint8_t const *p, size_t n);
+
+void RingFrameDec_ctor(RingFrameDec * const me, uint8_t const kind,
+                       uint8_t buf[], size_t buf_len);
+uint32_t RingFrameDec_process(RingFrameDec * const me, RingBuf * const rb,
+                              RingFrameHandler handler, void *ctx);
+
+#endif // RING_FRAME_H
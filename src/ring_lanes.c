@@ -0,0 +1,150 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_lanes.h"
+
+//............................................................................
+void RingLanes_ctor(RingLanes * const me, uint8_t const policy) {
+    me->n_lanes = 0U;
+    me->policy  = policy;
+    me->lane    = 0U;
+    me->credit  = 0U;
+}
+//............................................................................
+uint8_t RingLanes_add(RingLanes * const me,
+                      RingBufElement sto[], RingBufCtr sto_len,
+                      uint8_t const weight)
+{
+    uint8_t const lane = me->n_lanes;
+    if (lane < RING_LANES_MAX) {
+        RingBuf_ctor(&me->lanes[lane], sto, sto_len);
+        me->weights[lane] = (weight != 0U) ? weight : 1U;
+        atomic_store(&me->stats[lane].puts,  0U);
+        atomic_store(&me->stats[lane].drops, 0U);
+        atomic_store(&me->stats[lane].gets,  0U);
+        atomic_store(&me->stats[lane].hwm,   0U);
+        ++me->n_lanes;
+        if (lane == 0U) {
+            me->credit = me->weights[0];
+        }
+    }
+    return lane; // == RING_LANES_MAX when no more lanes are available
+}
+//............................................................................
+bool RingLanes_put(RingLanes * const me, uint8_t const lane,
+                   RingBufElement const el)
+{
+    RingBuf * const rb = &me->lanes[lane];
+    RingLaneStats * const st = &me->stats[lane];
+    if (RingBuf_put(rb, el)) {
+        atomic_store_explicit(&st->puts,
+            atomic_load_explicit(&st->puts, memory_order_relaxed) + 1U,
+            memory_order_relaxed);
+
+        // occupancy after the put (an over-estimate if the consumer has
+        // just removed elements, which is fine for the high-water mark)
+        RingBufCtr const used =
+            (RingBufCtr)(rb->end - 1U - RingBuf_num_free(rb));
+        if (used > atomic_load_explicit(&st->hwm, memory_order_relaxed)) {
+            atomic_store_explicit(&st->hwm, used, memory_order_relaxed);
+        }
+        return true;
+    }
+    else {
+        atomic_store_explicit(&st->drops,
+            atomic_load_explicit(&st->drops, memory_order_relaxed) + 1U,
+            memory_order_relaxed);
+        return false; // lane full
+    }
+}
+//............................................................................
+bool RingLanes_get(RingLanes * const me, uint8_t *plane,
+                   RingBufElement *pel)
+{
+    uint8_t lane;
+    bool got = false;
+    if (me->policy == RING_LANES_STRICT) {
+        for (lane = 0U; lane < me->n_lanes; ++lane) {
+            if (RingBuf_get(&me->lanes[lane], pel)) {
+                got = true;
+                break;
+            }
+        }
+    }
+    else { // RING_LANES_WRR
+        // the current lane and then every lane once (all empty?)
+        lane = me->lane;
+        for (uint8_t n = 0U; n <= me->n_lanes; ++n) {
+            if ((me->credit != 0U) && RingBuf_get(&me->lanes[lane], pel)) {
+                --me->credit;
+                got = true;
+                break;
+            }
+            // lane empty or its weight used up: next lane
+            ++lane;
+            if (lane == me->n_lanes) {
+                lane = 0U;
+            }
+            me->credit = me->weights[lane];
+        }
+        me->lane = lane;
+    }
+    if (got) {
+        RingLaneStats * const st = &me->stats[lane];
+        atomic_store_explicit(&st->gets,
+            atomic_load_explicit(&st->gets, memory_order_relaxed) + 1U,
+            memory_order_relaxed);
+        *plane = lane;
+    }
+    return got;
+}
+//............................................................................
+void RingLanes_process_all(RingLanes * const me, RingLanesHandler handler) {
+    uint8_t lane;
+    RingBufElement el;
+    while (RingLanes_get(me, &lane, &el)) {
+        (*handler)(lane, el);
+    }
+}
+//............................................................................
+void RingLanes_stats(RingLanes * const me, uint8_t const lane,
+                     RingLaneInfo * const info)
+{
+    RingBuf * const rb = &me->lanes[lane];
+    RingLaneStats * const st = &me->stats[lane];
+    info->puts  = atomic_load_explicit(&st->puts,  memory_order_relaxed);
+    info->drops = atomic_load_explicit(&st->drops, memory_order_relaxed);
+    info->gets  = atomic_load_explicit(&st->gets,  memory_order_relaxed);
+    info->hwm   = atomic_load_explicit(&st->hwm,   memory_order_relaxed);
+    info->used  = (RingBufCtr)(rb->end - 1U - RingBuf_num_free(rb));
+}
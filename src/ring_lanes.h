@@ -0,0 +1,115 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_LANES_H
+#define RING_LANES_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Maximum number of priority lanes in ::RingLanes
+#ifndef RING_LANES_MAX
+#define RING_LANES_MAX 4U
+#endif
+
+//! Drain policies of ::RingLanes
+enum RingLanesPolicy {
+    RING_LANES_STRICT, //!< lower lane index always first (lane 0 highest)
+    RING_LANES_WRR     //!< weighted round-robin (lane weight per round)
+};
+
+//! Per-lane statistics (one writer each, readable from anywhere)
+//
+// @details
+// The producer of the lane updates puts, drops, and the high-water mark
+// of the lane occupancy. The consumer updates gets. The counters are
+// updated with relaxed atomic loads/stores by their only writer (no
+// read-modify-write), so they cost a plain load/store on MCUs.
+//
+typedef struct {
+    _Atomic(uint32_t) puts;  //!< elements put into the lane
+    _Atomic(uint32_t) drops; //!< elements dropped because the lane was full
+    _Atomic(uint32_t) gets;  //!< elements removed from the lane
+    _Atomic(RingBufCtr) hwm; //!< high-water mark of the lane occupancy
+} RingLaneStats;
+
+//! Snapshot of the per-lane statistics, see RingLanes_stats()
+typedef struct {
+    uint32_t puts;   //!< elements put into the lane
+    uint32_t drops;  //!< elements dropped because the lane was full
+    uint32_t gets;   //!< elements removed from the lane
+    RingBufCtr hwm;  //!< high-water mark of the lane occupancy
+    RingBufCtr used; //!< current lane occupancy
+} RingLaneInfo;
+
+//! Multi-lane priority queue with one consumer
+//
+// @details
+// Every lane is a separate ::RingBuf with its own (single) producer,
+// so, for example, control messages and bulk data can be queued from
+// different threads/interrupts. The single consumer drains the lanes
+// with RingLanes_get() or RingLanes_process_all() according to the policy
+// selected in RingLanes_ctor():
+// - RING_LANES_STRICT: the element from the lowest-index non-empty lane,
+//   checked again before every element, so control traffic is never
+//   queued behind more than one bulk element;
+// - RING_LANES_WRR: up to `weight` elements from each lane in turn,
+//   so the low-priority lanes cannot be starved.
+//
+typedef struct {
+    RingBuf lanes[RING_LANES_MAX];       //!< lane ring buffers
+    RingLaneStats stats[RING_LANES_MAX]; //!< lane statistics
+    uint8_t weights[RING_LANES_MAX];     //!< lane weights (WRR policy)
+    uint8_t n_lanes;  //!< number of lanes
+    uint8_t policy;   //!< drain policy (::RingLanesPolicy)
+    uint8_t lane;     //!< current lane (consumer, WRR policy)
+    uint8_t credit;   //!< elements left in the current lane (WRR policy)
+} RingLanes;
+
+void RingLanes_ctor(RingLanes * const me, uint8_t const policy);
+uint8_t RingLanes_add(RingLanes * const me,
+                      RingBufElement sto[], RingBufCtr sto_len,
+                      uint8_t const weight);
+bool RingLanes_put(RingLanes * const me, uint8_t const lane,
+                   RingBufElement const el);
+bool RingLanes_get(RingLanes * const me, uint8_t *plane,
+                   RingBufElement *pel);
+void RingLanes_stats(RingLanes * const me, uint8_t const lane,
+                     RingLaneInfo * const info);
+
+//! Multi-lane callback function for RingLanes_process_all()
+typedef void (*RingLanesHandler)(uint8_t const lane, RingBufElement const el);
+
+void RingLanes_process_all(RingLanes * const me, RingLanesHandler handler);
+
+#endif // RING_LANES_H
@@ -0,0 +1,204 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_log.h"
+
+#define HDR_SIZE 3U // n_args:1, id:2
+
+//............................................................................
+void RingLog_ctor(RingLog * const me,
+                  RingBufElement sto[], RingBufCtr sto_len)
+{
+    RingBuf_ctor(&me->rb, sto, sto_len);
+    me->drops = 0U;
+}
+//............................................................................
+bool RingLog_write(RingLog * const me, uint16_t const id,
+                   uint8_t const n_args, uint32_t const args[])
+{
+    RingBufElement rec[HDR_SIZE + 4U*RING_LOG_MAX_ARGS];
+    uint8_t const n = n_args;
+    RingBufCtr const len = (RingBufCtr)(HDR_SIZE + 4U*n);
+
+    // a record with too many arguments (not logged through RING_LOG())
+    // is dropped as a whole rather than truncated.
+    // The free space is never over-estimated by the producer,
+    // so the whole record fits (no partial records)
+    if ((n > RING_LOG_MAX_ARGS) || (RingBuf_num_free(&me->rb) < len)) {
+        ++me->drops;
+        return false;
+    }
+    rec[0] = n;
+    rec[1] = (RingBufElement)(id & 0xFFU);
+    rec[2] = (RingBufElement)(id >> 8);
+    for (uint8_t i = 0U; i < n; ++i) {
+        uint32_t const a = args[i];
+        rec[HDR_SIZE + 4U*i]      = (RingBufElement)(a & 0xFFU);
+        rec[HDR_SIZE + 4U*i + 1U] = (RingBufElement)((a >> 8)  & 0xFFU);
+        rec[HDR_SIZE + 4U*i + 2U] = (RingBufElement)((a >> 16) & 0xFFU);
+        rec[HDR_SIZE + 4U*i + 3U] = (RingBufElement)(a >> 24);
+    }
+    (void)RingBuf_put_n(&me->rb, rec, len);
+    return true;
+}
+//............................................................................
+bool RingLog_read(RingLog * const me, RingLogRec * const rec) {
+    RingBufElement hdr[HDR_SIZE];
+    if (RingBuf_get_n(&me->rb, hdr, HDR_SIZE) != HDR_SIZE) {
+        return false; // no (complete) record
+    }
+    rec->n_args = hdr[0];
+    rec->id     = (uint16_t)(hdr[1] | ((uint16_t)hdr[2] << 8));
+
+    RingBufElement a[4U*RING_LOG_MAX_ARGS];
+    if (rec->n_args > RING_LOG_MAX_ARGS) { // corrupted record?
+        // the record boundaries are lost, so discard everything received
+        while (RingBuf_get_n(&me->rb, a, (RingBufCtr)sizeof(a))
+               == (RingBufCtr)sizeof(a))
+        {
+        }
+        return false;
+    }
+    // the arguments were published together with the header
+    (void)RingBuf_get_n(&me->rb, a, (RingBufCtr)(4U*rec->n_args));
+    for (uint8_t i = 0U; i < rec->n_args; ++i) {
+        rec->args[i] = (uint32_t)a[4U*i]
+                       | ((uint32_t)a[4U*i + 1U] << 8)
+                       | ((uint32_t)a[4U*i + 2U] << 16)
+                       | ((uint32_t)a[4U*i + 3U] << 24);
+    }
+    return true;
+}
+
+//............................................................................
+// minimal printf-style formatter of the argument words:
+// %d %i %u %x %X %c %% with the optional '0' flag and width (e.g., %08x)
+void RingLog_format(RingLogRec const * const rec,
+                    char const * const fmts[], uint16_t const n_fmts,
+                    RingLogPutc putc, void *ctx)
+{
+    if (rec->id >= n_fmts) {
+        static char const unknown[] = "<unknown log id>";
+        for (char const *s = unknown; *s != '\0'; ++s) {
+            (*putc)(*s, ctx);
+        }
+        return;
+    }
+    uint8_t arg = 0U;
+    for (char const *f = fmts[rec->id]; *f != '\0'; ++f) {
+        if (*f != '%') {
+            (*putc)(*f, ctx);
+            continue;
+        }
+        ++f;
+        char pad = ' ';
+        if (*f == '0') {
+            pad = '0';
+            ++f;
+        }
+        unsigned width = 0U;
+        for (; (*f >= '0') && (*f <= '9'); ++f) {
+            width = width*10U + (unsigned)(*f - '0');
+        }
+        if (*f == '%') {
+            (*putc)('%', ctx);
+            continue;
+        }
+        if (*f == '\0') {
+            break;
+        }
+        uint32_t const a = (arg < rec->n_args) ? rec->args[arg] : 0U;
+        ++arg;
+
+        char digits[12];
+        unsigned n = 0U;
+        bool neg = false;
+        uint32_t v = a;
+        uint32_t base = 10U;
+        switch (*f) {
+            case 'd':
+            case 'i':
+                if ((int32_t)a < 0) {
+                    neg = true;
+                    v = 0U - a;
+                }
+                break;
+            case 'u':
+                break;
+            case 'x':
+            case 'X':
+                base = 16U;
+                break;
+            case 'c':
+                (*putc)((char)a, ctx);
+                continue;
+            default: // unsupported conversion: print it as is
+                (*putc)('%', ctx);
+                (*putc)(*f, ctx);
+                continue;
+        }
+        char const * const hex = (*f == 'X')
+                                 ? "0123456789ABCDEF" : "0123456789abcdef";
+        do {
+            digits[n++] = hex[v % base];
+            v /= base;
+        } while (v != 0U);
+        if (neg) {
+            if (pad == '0') { // the sign goes before the zeros
+                (*putc)('-', ctx);
+                if (width != 0U) {
+                    --width;
+                }
+            }
+            else { // the sign counts in n
+                digits[n++] = '-';
+            }
+        }
+        for (; width > n; --width) {
+            (*putc)(pad, ctx);
+        }
+        while (n != 0U) {
+            (*putc)(digits[--n], ctx);
+        }
+    }
+}
+//............................................................................
+void RingLog_process_all(RingLog * const me,
+                         char const * const fmts[], uint16_t const n_fmts,
+                         RingLogPutc putc, void *ctx)
+{
+    RingLogRec rec;
+    while (RingLog_read(me, &rec)) {
+        RingLog_format(&rec, fmts, n_fmts, putc, ctx);
+    }
+}
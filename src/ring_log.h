@@ -0,0 +1,108 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_LOG_H
+#define RING_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Maximum number of the argument words in one log record
+#ifndef RING_LOG_MAX_ARGS
+#define RING_LOG_MAX_ARGS 6U
+#endif
+
+//! Deferred binary logger on top of the byte ::RingBuf
+//
+// @details
+// The producer (e.g., an ISR) writes only the format-string ID and the
+// raw 32-bit argument words into the ring buffer, as one record:
+//
+//     [n_args:1][id:2 (little endian)][arg0:4]...[argN-1:4]
+//
+// with a single RingBuf_put_n() (a single head update), so the consumer
+// never sees a partial record. The formatting is deferred to the consumer
+// (a low-priority thread, or the host that receives the raw records),
+// which looks up the format string by the ID, see RingLog_format().
+//
+// @attention
+// The ring buffer has a single producer, so every execution context that
+// logs needs its own ::RingLog (or a critical section around RING_LOG()).
+// The arguments are 32-bit words: integers, characters, and pointers on
+// 32-bit CPUs. Strings must be logged by ID (e.g., as another format).
+//
+typedef struct {
+    RingBuf rb;     //!< byte ring buffer of the log records
+    uint32_t drops; //!< records dropped (ring buffer full, too many args)
+} RingLog;
+
+//! Log record as read back by the consumer
+typedef struct {
+    uint16_t id;    //!< format-string ID
+    uint8_t n_args; //!< number of the argument words
+    uint32_t args[RING_LOG_MAX_ARGS]; //!< argument words
+} RingLogRec;
+
+//! Character output function for RingLog_format()
+typedef void (*RingLogPutc)(char const ch, void *ctx);
+
+void RingLog_ctor(RingLog * const me,
+                  RingBufElement sto[], RingBufCtr sto_len);
+bool RingLog_write(RingLog * const me, uint16_t const id,
+                   uint8_t const n_args, uint32_t const args[]);
+bool RingLog_read(RingLog * const me, RingLogRec * const rec);
+void RingLog_format(RingLogRec const * const rec,
+                    char const * const fmts[], uint16_t const n_fmts,
+                    RingLogPutc putc, void *ctx);
+void RingLog_process_all(RingLog * const me,
+                         char const * const fmts[], uint16_t const n_fmts,
+                         RingLogPutc putc, void *ctx);
+
+//! Log the format-string ID `id_` with the arguments (at least one,
+//! at most RING_LOG_MAX_ARGS, checked at compile time)
+#define RING_LOG(me_, id_, ...) \
+    ((void)sizeof(struct { \
+        _Static_assert(RING_LOG_N_ARGS_(__VA_ARGS__) <= RING_LOG_MAX_ARGS, \
+                       "RING_LOG: too many arguments"); \
+        int dummy_; }), \
+     RingLog_write((me_), (id_), (uint8_t)RING_LOG_N_ARGS_(__VA_ARGS__), \
+        (uint32_t[]){ __VA_ARGS__ }))
+
+// number of the arguments of RING_LOG() (an integer constant expression)
+#define RING_LOG_N_ARGS_(...) \
+    (sizeof((uint32_t[]){ __VA_ARGS__ }) / sizeof(uint32_t))
+
+//! Log the format-string ID `id_` without arguments
+#define RING_LOG0(me_, id_) \
+    RingLog_write((me_), (id_), 0U, (uint32_t const *)0)
+
+#endif // RING_LOG_H
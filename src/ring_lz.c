@@ -0,0 +1,303 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "ring_lz.h"
+
+_Static_assert(sizeof(RingBufElement) == 1U,
+               "ring_lz.c requires RingBufElement of one byte");
+
+#define MIN_MATCH     4U  // minimum match length
+#define LAST_LITERALS 5U  // the last bytes are always literals
+#define MF_LIMIT      12U // the last match must start before that
+
+_Static_assert(RING_LZ_MIN_BLOCK == MF_LIMIT + 1U,
+               "RING_LZ_MIN_BLOCK inconsistent with MF_LIMIT");
+
+static uint32_t read32(uint8_t const *p);
+static uint32_t hash(uint32_t const x);
+static uint8_t *put_len(uint8_t *op, uint8_t const *oend, size_t len);
+
+//............................................................................
+void RingLz_ctor(RingLz * const me, uint8_t in[], uint8_t out[],
+                 size_t block_len)
+{
+    me->in        = in;
+    me->out       = out;
+    me->block_len = (block_len < RING_LZ_MIN_BLOCK) ? RING_LZ_MIN_BLOCK
+                    : (block_len > RING_LZ_MAX_BLOCK) ? RING_LZ_MAX_BLOCK
+                    : block_len;
+    me->n_raw     = 0U;
+    me->n_packed  = 0U;
+}
+//............................................................................
+// Moves one block from 'src' to 'dst', when 'src' holds a full block (or
+// any data with 'flush'), and 'dst' has room for it. Returns the number
+// of the raw bytes taken from 'src'. Called by the consumer of 'src' and
+// the producer of 'dst'.
+size_t RingLz_pump(RingLz * const me, RingBuf * const src,
+                   RingBuf * const dst, bool const flush)
+{
+    RingBufCtr const n_used =
+        (RingBufCtr)(src->end - 1U - RingBuf_num_free(src));
+    if (((size_t)n_used < me->block_len) && !(flush && (n_used != 0U))) {
+        return 0U; // wait for the full block
+    }
+    // the raw block (the worst case) must fit into 'dst'
+    RingBufCtr const n =
+        ((size_t)n_used < me->block_len) ? n_used : (RingBufCtr)me->block_len;
+    if (n == 0U) { // nothing to compress (the cap below would underflow)
+        return 0U;
+    }
+    if ((size_t)RingBuf_num_free(dst) < (size_t)n + 2U) {
+        return 0U;
+    }
+    RingBuf_get_n(src, me->in, n);
+
+    size_t len = RingLz_compress(me, me->in, n, &me->out[2], (size_t)n - 1U);
+    uint16_t hdr;
+    if (len != 0U) {
+        hdr = (uint16_t)(len | 0x8000U);
+    }
+    else { // incompressible, store raw
+        memcpy(&me->out[2], me->in, n);
+        len = n;
+        hdr = (uint16_t)len;
+    }
+    me->out[0] = (uint8_t)hdr;
+    me->out[1] = (uint8_t)(hdr >> 8);
+    RingBuf_put_n(dst, me->out, (RingBufCtr)(len + 2U));
+    me->n_raw    += n;
+    me->n_packed += (uint32_t)(len + 2U);
+    return n;
+}
+//............................................................................
+// Reads one framed block from 'rb' and decompresses it into 'out' (the
+// 'tmp' buffer must hold 'cap' bytes). Returns the length of the data in
+// 'out', 0 when 'rb' is empty, or RING_LZ_ERROR. A block that does not
+// fit into 'cap' is discarded, so the next call reads the next block.
+// Called by the consumer.
+size_t RingLz_read(RingBuf * const rb, uint8_t tmp[],
+                   uint8_t out[], size_t cap)
+{
+    uint8_t h[2];
+    if (RingBuf_get_n(rb, h, 2U) != 2U) { // blocks are put as a whole
+        return 0U;
+    }
+    uint16_t const hdr = (uint16_t)(h[0] | ((uint16_t)h[1] << 8));
+    size_t const len = hdr & 0x7FFFU;
+    if (len > cap) { // skip the payload to stay in sync with the stream
+        uint8_t junk[16];
+        size_t n = len;
+        while (n != 0U) {
+            RingBufCtr const k = (RingBufCtr)((n < sizeof(junk))
+                                              ? n : sizeof(junk));
+            if (RingBuf_get_n(rb, junk, k) != k) {
+                break;
+            }
+            n -= k;
+        }
+        return RING_LZ_ERROR;
+    }
+    if ((hdr & 0x8000U) == 0U) { // stored raw?
+        RingBuf_get_n(rb, out, (RingBufCtr)len);
+        return len;
+    }
+    RingBuf_get_n(rb, tmp, (RingBufCtr)len);
+    return RingLz_decompress(tmp, len, out, cap);
+}
+
+//............................................................................
+// Compresses src[0..n) into dst[0..cap) in the LZ4 block format.
+// Returns the compressed length, or 0 when it does not fit into 'cap'.
+size_t RingLz_compress(RingLz * const me, uint8_t const *src, size_t n,
+                       uint8_t *dst, size_t cap)
+{
+    uint8_t *op = dst;
+    uint8_t const * const oend = &dst[cap];
+    size_t anchor = 0U; // start of the pending literals
+    size_t ip = 0U;
+    if (n > RING_LZ_MAX_BLOCK) { // 16-bit positions in the hash table
+        return 0U;
+    }
+    if (n > MF_LIMIT) {
+        memset(me->tab, 0, sizeof(me->tab));
+        size_t const limit = n - MF_LIMIT;
+        size_t const match_limit = n - LAST_LITERALS;
+        while (ip < limit) {
+            uint32_t const seq = read32(&src[ip]);
+            uint32_t const h = hash(seq);
+            size_t const ref = me->tab[h];
+            me->tab[h] = (uint16_t)ip;
+            if ((ref >= ip) || (read32(&src[ref]) != seq)) {
+                // skip faster over the incompressible data
+                ip += 1U + ((ip - anchor) >> 6);
+                continue;
+            }
+            size_t ml = MIN_MATCH;
+            while ((ip + ml < match_limit) && (src[ref + ml] == src[ip + ml])) {
+                ++ml;
+            }
+            // sequence: token, literals, offset, match length
+            size_t const lit = ip - anchor;
+            if ((size_t)(oend - op) < lit + lit/255U + 1U + 2U + 1U) {
+                return 0U;
+            }
+            uint8_t * const token = op++;
+            *token = (uint8_t)(((lit < 15U) ? lit : 15U) << 4);
+            if (lit >= 15U) {
+                op = put_len(op, oend, lit - 15U);
+            }
+            memcpy(op, &src[anchor], lit);
+            op += lit;
+            size_t const off = ip - ref;
+            *op++ = (uint8_t)off;
+            *op++ = (uint8_t)(off >> 8);
+            size_t const mlc = ml - MIN_MATCH;
+            *token |= (uint8_t)((mlc < 15U) ? mlc : 15U);
+            if (mlc >= 15U) {
+                op = put_len(op, oend, mlc - 15U);
+                if (op == (uint8_t *)0) {
+                    return 0U;
+                }
+            }
+            ip += ml;
+            anchor = ip;
+        }
+    }
+    // the last literals
+    size_t const lit = n - anchor;
+    if ((size_t)(oend - op) < lit + lit/255U + 2U) {
+        return 0U;
+    }
+    uint8_t * const token = op++;
+    *token = (uint8_t)(((lit < 15U) ? lit : 15U) << 4);
+    if (lit >= 15U) {
+        op = put_len(op, oend, lit - 15U);
+    }
+    memcpy(op, &src[anchor], lit);
+    op += lit;
+    return (size_t)(op - dst);
+}
+//............................................................................
+// Decompresses the LZ4 block src[0..n) into dst[0..cap). Returns the
+// decompressed length, or RING_LZ_ERROR for the corrupted data.
+size_t RingLz_decompress(uint8_t const *src, size_t n,
+                         uint8_t *dst, size_t cap)
+{
+    size_t ip = 0U;
+    size_t op = 0U;
+    while (ip < n) {
+        uint8_t const token = src[ip++];
+        size_t len = token >> 4; // literals
+        if (len == 15U) {
+            uint8_t b;
+            do {
+                if (ip == n) {
+                    return RING_LZ_ERROR;
+                }
+                b = src[ip++];
+                len += b;
+            } while (b == 255U);
+        }
+        if ((len > n - ip) || (len > cap - op)) {
+            return RING_LZ_ERROR;
+        }
+        memcpy(&dst[op], &src[ip], len);
+        ip += len;
+        op += len;
+        if (ip == n) { // the last literals?
+            break;
+        }
+        if (n - ip < 2U) {
+            return RING_LZ_ERROR;
+        }
+        size_t const off = src[ip] | ((size_t)src[ip + 1U] << 8);
+        ip += 2U;
+        if ((off == 0U) || (off > op)) {
+            return RING_LZ_ERROR;
+        }
+        len = token & 0xFU; // match
+        if (len == 15U) {
+            uint8_t b;
+            do {
+                if (ip == n) {
+                    return RING_LZ_ERROR;
+                }
+                b = src[ip++];
+                len += b;
+            } while (b == 255U);
+        }
+        len += MIN_MATCH;
+        if (len > cap - op) {
+            return RING_LZ_ERROR;
+        }
+        if (off >= len) { // no overlap?
+            memcpy(&dst[op], &dst[op - off], len);
+            op += len;
+        }
+        else { // overlapping copy (e.g., runs of the same value)
+            for (size_t i = 0U; i < len; ++i, ++op) {
+                dst[op] = dst[op - off];
+            }
+        }
+    }
+    return op;
+}
+
+//............................................................................
+static uint32_t read32(uint8_t const *p) {
+    uint32_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+//............................................................................
+static uint32_t hash(uint32_t const x) {
+    return (x * 2654435761U) >> (32U - RING_LZ_HASH_BITS);
+}
+//............................................................................
+// writes the extra length bytes (255, 255, ..., rest); NULL on overflow
+static uint8_t *put_len(uint8_t *op, uint8_t const *oend, size_t len) {
+    for (; len >= 255U; len -= 255U) {
+        if (op == oend) {
+            return (uint8_t *)0;
+        }
+        *op++ = 255U;
+    }
+    if (op == oend) {
+        return (uint8_t *)0;
+    }
+    *op++ = (uint8_t)len;
+    return op;
+}
@@ -0,0 +1,102 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_LZ_H
+#define RING_LZ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buf.h"
+
+//! Size of the match-finder hash table of ::RingLz [log2(entries)]
+//
+// @details
+// The table takes 2 bytes per entry (8KB for the default 12 bits). Small
+// MCUs can trade the compression ratio for RAM with e.g. 8 bits (512B).
+//
+#ifndef RING_LZ_HASH_BITS
+#define RING_LZ_HASH_BITS 12U
+#endif
+
+//! Maximum length of a block for ::RingLz [bytes]
+#define RING_LZ_MAX_BLOCK 0x7FFFU
+
+//! Minimum length of a block for ::RingLz [bytes]
+//
+// @details
+// Shorter blocks cannot contain a match (see MF_LIMIT in ring_lz.c).
+// RingLz_ctor() clamps the `block_len` to the range
+// [RING_LZ_MIN_BLOCK, RING_LZ_MAX_BLOCK], and the `in` and `out` buffers
+// must be sized for the clamped length.
+//
+#define RING_LZ_MIN_BLOCK 13U
+
+//! Streaming compression stage between two byte ring buffers
+//
+// @details
+// RingLz_pump() takes a block of up to `block_len` bytes from the source
+// ring buffer, compresses it with the in-tree LZ77 codec (the LZ4 block
+// format: greedy hash-chain-free matching, 4-byte minimum match, 16-bit
+// offsets), and writes it as one framed block into the destination ring
+// buffer (a single head update):
+//
+//     [hdr:2 (little endian)][data:len]
+//
+// where `hdr` is the data length with the bit 15 set for the compressed
+// data (the block is stored raw when it does not compress). The other end
+// of the link reads the blocks back with RingLz_read().
+//
+typedef struct {
+    uint8_t *in;       //!< raw block buffer [block_len]
+    uint8_t *out;      //!< framed block buffer [block_len + 2]
+    size_t block_len;  //!< maximum length of the block [bytes]
+    uint32_t n_raw;    //!< number of the raw bytes taken from the source
+    uint32_t n_packed; //!< number of the framed bytes put into the dest.
+    uint16_t tab[1U << RING_LZ_HASH_BITS]; //!< match-finder hash table
+} RingLz;
+
+void RingLz_ctor(RingLz * const me, uint8_t in[], uint8_t out[],
+                 size_t block_len);
+size_t RingLz_pump(RingLz * const me, RingBuf * const src,
+                   RingBuf * const dst, bool const flush);
+size_t RingLz_read(RingBuf * const rb, uint8_t tmp[],
+                   uint8_t out[], size_t cap);
+
+size_t RingLz_compress(RingLz * const me, uint8_t const *src, size_t n,
+                       uint8_t *dst, size_t cap);
+size_t RingLz_decompress(uint8_t const *src, size_t n,
+                         uint8_t *dst, size_t cap);
+
+//! Returned by RingLz_read()/RingLz_decompress() for corrupted data
+#define RING_LZ_ERROR (~(size_t)0)
+
+#endif // RING_LZ_H
@@ -0,0 +1,127 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_notify.h"
+
+static RingBufCtr occupancy(RingNotify const * const me);
+static void check(RingNotify * const me, RingBufCtr const used);
+
+//............................................................................
+void RingNotify_ctor(RingNotify * const me, RingBuf * const rb,
+                     RingBufCtr const high, RingBufCtr const low,
+                     uint32_t const timeout, RingNotifyClock clock,
+                     RingNotifyFn notify, void *ctx)
+{
+    me->rb      = rb;
+    me->high    = (high != 0U) ? high : 1U;
+    me->low     = (low < me->high) ? low : (RingBufCtr)(me->high - 1U);
+    me->timeout = timeout;
+    me->clock   = clock;
+    me->notify  = notify;
+    me->ctx     = ctx;
+    atomic_store(&me->armed, true);
+    me->pending  = false;
+    me->t_first  = 0U;
+    me->n_notify = 0U;
+}
+//............................................................................
+bool RingNotify_put(RingNotify * const me, RingBufElement const el) {
+    if (!RingBuf_put(me->rb, el)) {
+        return false; // buffer full
+    }
+    // first element since the ring buffer was empty? (the consumer might
+    // have drained it after the last check())
+    if ((!me->pending) || (occupancy(me) == 1U)) {
+        me->pending = true;
+        if (me->timeout != 0U) {
+            me->t_first = (*me->clock)();
+        }
+    }
+    // the fence orders the head store in RingBuf_put() before the load of
+    // 'armed', which pairs with the fence in RingNotify_arm()
+    atomic_thread_fence(memory_order_seq_cst);
+    check(me, occupancy(me));
+    return true;
+}
+//............................................................................
+void RingNotify_tick(RingNotify * const me) {
+    if (me->pending) {
+        check(me, occupancy(me));
+    }
+}
+//............................................................................
+bool RingNotify_arm(RingNotify * const me) {
+    if (occupancy(me) > me->low) {
+        return false; // keep draining
+    }
+    atomic_store(&me->armed, true); // seq_cst
+    // the fence orders the store of 'armed' before the load of the head
+    // in the re-check, which pairs with the fence in RingNotify_put():
+    // either the producer sees 'armed' or the re-check sees the put
+    atomic_thread_fence(memory_order_seq_cst);
+    // re-check, in case the producer has missed the armed flag
+    if (occupancy(me) >= me->high) {
+        atomic_store(&me->armed, false);
+        return false;
+    }
+    return true; // the consumer can wait for the notification
+}
+
+//............................................................................
+static RingBufCtr occupancy(RingNotify const * const me) {
+    return (RingBufCtr)(me->rb->end - 1U - RingBuf_num_free(me->rb));
+}
+//............................................................................
+static void check(RingNotify * const me, RingBufCtr const used) {
+    if (used == 0U) { // the consumer has drained the pending elements?
+        me->pending = false;
+        return;
+    }
+    if (!atomic_load_explicit(&me->armed, memory_order_relaxed)) {
+        return; // the consumer is already notified and draining
+    }
+    bool trigger = (used >= me->high);
+    if ((!trigger) && (me->timeout != 0U)) {
+        trigger = ((uint32_t)((*me->clock)() - me->t_first) >= me->timeout);
+    }
+    if (trigger) {
+        atomic_store_explicit(&me->armed, false, memory_order_relaxed);
+        // the elements stay pending until the ring buffer is empty, and
+        // the timeout restarts for those left when the consumer re-arms
+        if (me->timeout != 0U) {
+            me->t_first = (*me->clock)();
+        }
+        ++me->n_notify;
+        (*me->notify)(me->ctx);
+    }
+}
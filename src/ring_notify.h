@@ -0,0 +1,103 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_NOTIFY_H
+#define RING_NOTIFY_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Notification callback of ::RingNotify (e.g., semaphore, futex, eventfd)
+typedef void (*RingNotifyFn)(void *ctx);
+
+//! Clock of ::RingNotify for the coalescing timeout (any time unit)
+typedef uint32_t (*RingNotifyClock)(void);
+
+//! Coalesced consumer notification (interrupt coalescing as in NICs)
+//
+// @details
+// The producer calls RingNotify_put() instead of RingBuf_put(). The
+// consumer is notified (callback) only when it is "armed" and either:
+// - the occupancy reaches the `high` watermark, or
+// - the oldest element not yet notified has waited `timeout` clock units
+//   (checked in RingNotify_put() and in the periodic RingNotify_tick()).
+//
+// After the notification, the consumer is disarmed and drains the ring
+// buffer. It re-arms with RingNotify_arm() before waiting again, which
+// succeeds only when the occupancy has dropped to the `low` watermark.
+// The elements still in the ring buffer at that point stay pending, so
+// they are notified again after the `timeout` (counted from the last
+// notification), even if the producer puts nothing more. Without the
+// timeout, they are notified only at the `high` watermark, so use
+// `low = 0` in that case.
+//
+// @note
+// The producer disarms (true -> false) when it notifies. The consumer
+// arms (false -> true) in RingNotify_arm(), and disarms again only when
+// its re-check finds the `high` watermark already reached, in which case
+// it keeps draining instead of waiting. A notification racing with that
+// is then spurious, which the consumer must tolerate (as any wake-up of
+// a semaphore). Plain stores are enough, the `armed` flag needs no
+// read-modify-write. RingNotify_tick() must run in the producer context
+// (or at the same interrupt priority), because it shares the producer
+// state.
+//
+typedef struct {
+    RingBuf *rb;          //!< the ring buffer
+    RingBufCtr high;      //!< notify at this occupancy
+    RingBufCtr low;       //!< re-arm only at/below this occupancy
+    uint32_t timeout;     //!< coalescing timeout (0 means no timeout)
+    RingNotifyClock clock; //!< clock for the timeout
+    RingNotifyFn notify;  //!< notification callback
+    void *ctx;            //!< context for the notification callback
+
+    _Atomic(bool) armed;  //!< consumer waits for a notification
+    bool pending;         //!< elements in the ring since it was empty
+    uint32_t t_first;     //!< time of the first pending element or of
+                          //!< the last notification
+    uint32_t n_notify;    //!< number of notifications (statistics)
+} RingNotify;
+
+void RingNotify_ctor(RingNotify * const me, RingBuf * const rb,
+                     RingBufCtr const high, RingBufCtr const low,
+                     uint32_t const timeout, RingNotifyClock clock,
+                     RingNotifyFn notify, void *ctx);
+
+// producer side
+bool RingNotify_put(RingNotify * const me, RingBufElement const el);
+void RingNotify_tick(RingNotify * const me);
+
+// consumer side
+bool RingNotify_arm(RingNotify * const me);
+
+#endif // RING_NOTIFY_H
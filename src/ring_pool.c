@@ -0,0 +1,51 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_pool.h"
+
+//............................................................................
+// The free_sto[] and ev_sto[] must have n_blocks + 1 elements each, and
+// n_blocks must not exceed the range of RingBufElement.
+void RingPool_ctor(RingPool * const me, void *blocks, size_t block_size,
+                   RingBufCtr n_blocks,
+                   RingBufElement free_sto[], RingBufElement ev_sto[])
+{
+    me->blocks     = (uint8_t *)blocks;
+    me->block_size = block_size;
+    RingBuf_ctor(&me->free_list, free_sto, (RingBufCtr)(n_blocks + 1U));
+    RingBuf_ctor(&me->events,    ev_sto,   (RingBufCtr)(n_blocks + 1U));
+    for (RingBufCtr h = 0U; h < n_blocks; ++h) { // all blocks are free
+        (void)RingBuf_put(&me->free_list, (RingBufElement)h);
+    }
+}
@@ -0,0 +1,93 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_POOL_H
+#define RING_POOL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buf.h"
+
+//! Fixed-block memory pool with an event ring of the block handles
+//
+// @details
+// The blocks are identified by the handles 0..n_blocks-1 stored as
+// ::RingBufElement (so up to 255 blocks with the default `uint8_t`).
+// Two lock-free SPSC ring buffers of the handles connect the sender and
+// the receiver of the events:
+//
+// - `free_list` of the free blocks: RingPool_free() by the receiver puts
+//   into it, RingPool_alloc() by the sender gets from it;
+// - `events` of the sent blocks: RingPool_send() by the sender puts into
+//   it, RingPool_recv() by the receiver gets from it.
+//
+// Each ring has one producer and one consumer, so the allocation, send,
+// receive and free all take O(1) time without locks and without the heap.
+// Both rings have `n_blocks + 1` elements, so RingPool_send() cannot fail
+// for a block that was allocated from the pool.
+//
+typedef struct {
+    RingBuf free_list;  //!< handles of the free blocks
+    RingBuf events;     //!< handles of the sent blocks (events)
+    uint8_t *blocks;    //!< storage of the blocks
+    size_t block_size;  //!< size of one block [bytes]
+} RingPool;
+
+void RingPool_ctor(RingPool * const me, void *blocks, size_t block_size,
+                   RingBufCtr n_blocks,
+                   RingBufElement free_sto[], RingBufElement ev_sto[]);
+
+//! Pointer to the block with the given handle
+static inline void *RingPool_ptr(RingPool const * const me,
+                                 RingBufElement const h)
+{
+    return &me->blocks[(size_t)h * me->block_size];
+}
+
+//! Allocate a block (sender); returns false when the pool is empty
+static inline bool RingPool_alloc(RingPool * const me, RingBufElement *ph) {
+    return RingBuf_get(&me->free_list, ph);
+}
+//! Send the allocated block to the receiver (sender)
+static inline void RingPool_send(RingPool * const me, RingBufElement h) {
+    (void)RingBuf_put(&me->events, h);
+}
+//! Receive the next block (receiver); returns false when there is none
+static inline bool RingPool_recv(RingPool * const me, RingBufElement *ph) {
+    return RingBuf_get(&me->events, ph);
+}
+//! Return the received block to the pool (receiver)
+static inline void RingPool_free(RingPool * const me, RingBufElement h) {
+    (void)RingBuf_put(&me->free_list, h);
+}
+
+#endif // RING_POOL_H
@@ -0,0 +1,171 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifdef __linux__
+#define _GNU_SOURCE // for syscall()
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_set.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+
+//! count trailing zeros of a non-zero 32-bit bitmap
+#if defined(__GNUC__) || defined(__clang__)
+#define RING_SET_CTZ(bits_) ((uint8_t)__builtin_ctz(bits_))
+#else
+static uint8_t RING_SET_CTZ(uint32_t bits) {
+    uint8_t n = 0U;
+    for (; (bits & 1U) == 0U; bits >>= 1) {
+        ++n;
+    }
+    return n;
+}
+#endif
+
+//! blocking of the consumer in RingSet_wait() until RING_SET_SIGNAL()
+//
+// @details
+// The default on Linux is the futex on the ready bitmap. Other systems
+// can define both macros (e.g., RTOS semaphore, or WFI/SEV on MCUs).
+// Without the macros, RingSet_wait() polls the ready bitmap.
+//
+#ifndef RING_SET_WAIT
+#ifdef __linux__
+#define RING_SET_WAIT(me_) \
+    ((void)syscall(SYS_futex, &(me_)->ready, FUTEX_WAIT_PRIVATE, 0U, \
+                   (void *)0, (void *)0, 0))
+#define RING_SET_SIGNAL(me_) \
+    ((void)syscall(SYS_futex, &(me_)->ready, FUTEX_WAKE_PRIVATE, 1, \
+                   (void *)0, (void *)0, 0))
+#else
+#define RING_SET_WAIT(me_)   ((void)0)
+#define RING_SET_SIGNAL(me_) ((void)0)
+#endif
+#endif // RING_SET_WAIT
+
+static bool ring_empty(RingBuf * const rb);
+
+//............................................................................
+void RingSet_ctor(RingSet * const me) {
+    me->n_rings = 0U;
+    me->next    = 0U;
+    atomic_store(&me->ready, 0U);
+}
+//............................................................................
+uint8_t RingSet_add(RingSet * const me, RingBuf * const rb) {
+    uint8_t const idx = me->n_rings;
+    if (idx < RING_SET_MAX) {
+        me->rings[idx] = rb;
+        ++me->n_rings;
+    }
+    return idx; // == RING_SET_MAX when the set is full
+}
+//............................................................................
+bool RingSet_put(RingSet * const me, uint8_t const idx,
+                 RingBufElement const el)
+{
+    if (!RingBuf_put(me->rings[idx], el)) {
+        return false; // buffer full
+    }
+    uint32_t const bit = (uint32_t)1U << idx;
+
+    // The fence orders the head store in RingBuf_put() before the load
+    // of the bitmap, which pairs with the consumer clearing the bit and
+    // then re-checking the head. So either the producer sees the bit
+    // cleared or the consumer sees the new element.
+    atomic_thread_fence(memory_order_seq_cst);
+    if ((atomic_load_explicit(&me->ready, memory_order_relaxed) & bit)
+        == 0U)
+    {
+        // empty-to-non-empty edge (the bit is usually already set)
+        uint32_t const prev = atomic_fetch_or(&me->ready, bit);
+        if (prev == 0U) { // the consumer might be waiting?
+            RING_SET_SIGNAL(me);
+        }
+    }
+    return true;
+}
+//............................................................................
+bool RingSet_get(RingSet * const me, uint8_t *pidx, RingBufElement *pel) {
+    uint32_t ready = atomic_load_explicit(&me->ready, memory_order_acquire);
+    while (ready != 0U) {
+        // round-robin: the ready rings starting from me->next first
+        uint32_t const upper = ready & ~(((uint32_t)1U << me->next) - 1U);
+        uint8_t const idx = RING_SET_CTZ((upper != 0U) ? upper : ready);
+        RingBuf * const rb = me->rings[idx];
+        uint32_t const bit = (uint32_t)1U << idx;
+
+        if (RingBuf_get(rb, pel)) {
+            *pidx = idx;
+            me->next = (uint8_t)((idx + 1U < RING_SET_MAX) ? (idx + 1U) : 0U);
+            return true;
+        }
+
+        // the ring is empty, clear its bit, but re-check the ring
+        // after that, in case the producer has just put an element.
+        // The fence orders the bit clearing before the load of the head
+        // and pairs with the fence in RingSet_put() (store-buffering).
+        atomic_fetch_and(&me->ready, ~bit);
+        atomic_thread_fence(memory_order_seq_cst);
+        if (!ring_empty(rb)) {
+            atomic_fetch_or(&me->ready, bit);
+        }
+        else {
+            ready &= ~bit;
+        }
+    }
+    return false;
+}
+//............................................................................
+void RingSet_wait(RingSet * const me) {
+    while (atomic_load_explicit(&me->ready, memory_order_acquire) == 0U) {
+        RING_SET_WAIT(me); // returns immediately if ready != 0
+    }
+}
+//............................................................................
+void RingSet_process_all(RingSet * const me, RingSetHandler handler) {
+    uint8_t idx;
+    RingBufElement el;
+    while (RingSet_get(me, &idx, &el)) {
+        (*handler)(idx, el);
+    }
+}
+
+//............................................................................
+static bool ring_empty(RingBuf * const rb) {
+    return RingBuf_num_free(rb) == (RingBufCtr)(rb->end - 1U);
+}
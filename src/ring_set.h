@@ -0,0 +1,84 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_SET_H
+#define RING_SET_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Maximum number of ring buffers in a ::RingSet (1..32)
+#ifndef RING_SET_MAX
+#define RING_SET_MAX 32U
+#endif
+
+//! Set of ring buffers serviced by one consumer
+//
+// @details
+// The producers of the individual ring buffers put elements with
+// RingSet_put(), which marks the ring buffer as "ready" in a shared
+// bitmap. The consumer finds the ready ring buffers with the count-trailing-
+// zeros instruction, so the cost of servicing the set scales with the
+// number of active ring buffers rather than with the total number.
+// The ready ring buffers are serviced in round-robin order.
+//
+// @attention
+// Every ring buffer in the set still must have only one producer, but
+// the producers of different ring buffers can run concurrently. They
+// update the bitmap with atomic read-modify-write operations, which
+// require either lock-free atomics (e.g., ARMv7-M LDREX/STREX) or
+// the `__atomic_fetch_or_4()`/`__atomic_fetch_and_4()` functions
+// implemented with a critical section (e.g., ARMv6-M).
+//
+typedef struct {
+    RingBuf *rings[RING_SET_MAX]; //!< ring buffers in the set
+    uint8_t n_rings;  //!< number of ring buffers in the set
+    uint8_t next;     //!< next ring buffer in round-robin order (consumer)
+
+    //! atomic bitmap of ring buffers that (potentially) have elements
+    _Atomic(uint32_t) ready;
+} RingSet;
+
+void RingSet_ctor(RingSet * const me);
+uint8_t RingSet_add(RingSet * const me, RingBuf * const rb);
+bool RingSet_put(RingSet * const me, uint8_t const idx,
+                 RingBufElement const el);
+bool RingSet_get(RingSet * const me, uint8_t *pidx, RingBufElement *pel);
+void RingSet_wait(RingSet * const me);
+
+//! Ring set callback function for RingSet_process_all()
+typedef void (*RingSetHandler)(uint8_t const idx, RingBufElement const el);
+
+void RingSet_process_all(RingSet * const me, RingSetHandler handler);
+
+#endif // RING_SET_H
@@ -0,0 +1,151 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_share.h"
+
+static void reclaim(RingShare * const me);
+
+//............................................................................
+// The handles are the indices of descs[], so n_descs must not exceed the
+// range of RingBufElement.
+void RingShare_ctor(RingShare * const me, uint8_t arena[],
+                    uint32_t arena_len, RingDesc descs[], RingBufCtr n_descs)
+{
+    me->arena     = arena;
+    me->arena_len = arena_len;
+    me->descs     = descs;
+    me->n_descs   = n_descs;
+    me->head      = 0U;
+    me->tail      = 0U;
+    me->d_head    = 0U;
+    me->d_tail    = 0U;
+    me->n_used    = 0U;
+    for (RingBufCtr i = 0U; i < n_descs; ++i) {
+        atomic_store(&descs[i].refs, 0U);
+    }
+}
+//............................................................................
+// Allocates a contiguous slice of 'len' (> 0) bytes. Returns false when
+// the slice (or a descriptor) is not available. Called by the producer.
+bool RingShare_alloc(RingShare * const me, uint32_t len,
+                     RingBufElement *ph)
+{
+    reclaim(me);
+    if ((me->n_used == me->n_descs) || (len == 0U)) {
+        return false;
+    }
+    uint32_t off;
+    if (me->n_used == 0U) { // arena empty? start from the beginning
+        off = 0U;
+        me->tail = 0U;
+        if (len > me->arena_len) {
+            return false;
+        }
+    }
+    else if (me->head > me->tail) { // free space at the end and start
+        if (len <= me->arena_len - me->head) {
+            off = me->head;
+        }
+        else if (len <= me->tail) { // wrap around (skip the end)
+            off = 0U;
+        }
+        else {
+            return false;
+        }
+    }
+    else { // free space between the head and tail (none when equal)
+        if (len <= me->tail - me->head) {
+            off = me->head;
+        }
+        else {
+            return false;
+        }
+    }
+    RingDesc * const d = &me->descs[me->d_head];
+    d->off = off;
+    d->len = len;
+    atomic_store_explicit(&d->refs, 1U, memory_order_relaxed); // producer
+    *ph = (RingBufElement)me->d_head;
+    me->head = off + len;
+    ++me->d_head;
+    if (me->d_head == me->n_descs) {
+        me->d_head = 0U;
+    }
+    ++me->n_used;
+    return true;
+}
+//............................................................................
+// Puts the handle 'h' into the ring buffers of all consumers and hands
+// over the producer's reference. Returns the number of the ring buffers
+// that got it (the full ring buffers are skipped). Called by the producer.
+unsigned RingShare_publish(RingShare * const me, RingBufElement const h,
+                           RingBuf * const rings[], unsigned n_rings)
+{
+    RingDesc * const d = &me->descs[h];
+    // the references of all consumers must be counted before any of them
+    // can get the handle and release it
+    atomic_store_explicit(&d->refs, n_rings + 1U, memory_order_relaxed);
+    unsigned n = 0U;
+    for (unsigned i = 0U; i < n_rings; ++i) {
+        if (RingBuf_put(rings[i], h)) { // release (the slice and refs)
+            ++n;
+        }
+    }
+    // drop the references of the skipped consumers and of the producer
+    atomic_fetch_sub_explicit(&d->refs, (n_rings - n) + 1U,
+                              memory_order_release);
+    return n;
+}
+//............................................................................
+// Releases the consumer's reference to the slice of the handle 'h'.
+void RingShare_release(RingShare * const me, RingBufElement const h) {
+    // release: the accesses to the slice happen before its reuse
+    atomic_fetch_sub_explicit(&me->descs[h].refs, 1U, memory_order_release);
+}
+
+//............................................................................
+// reclaims the oldest slices that are no longer referenced (producer)
+static void reclaim(RingShare * const me) {
+    while ((me->n_used != 0U)
+           && (atomic_load_explicit(&me->descs[me->d_tail].refs,
+                                    memory_order_acquire) == 0U))
+    {
+        ++me->d_tail;
+        if (me->d_tail == me->n_descs) {
+            me->d_tail = 0U;
+        }
+        --me->n_used;
+    }
+    me->tail = (me->n_used != 0U) ? me->descs[me->d_tail].off : me->head;
+}
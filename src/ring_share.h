@@ -0,0 +1,99 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_SHARE_H
+#define RING_SHARE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "ring_buf.h"
+
+//! Descriptor of a slice of the ::RingShare arena
+typedef struct {
+    uint32_t off;             //!< offset of the slice in the arena
+    uint32_t len;             //!< length of the slice [bytes]
+    _Atomic(uint32_t) refs;   //!< number of the holders of the slice
+} RingDesc;
+
+//! Reference-counted arena shared by the broadcast consumers
+//
+// @details
+// The producer allocates a slice of the arena (RingShare_alloc()), fills
+// it, and RingShare_publish() puts only the handle of its ::RingDesc into
+// the ring buffers of all the consumers, after setting the reference
+// count to the number of the consumers that got it. Each consumer gets
+// the handle from its own ring buffer, accesses the slice with
+// RingShare_ptr() and RingShare_len(), and calls RingShare_release().
+// So the fan-out costs O(handle) per consumer instead of O(payload).
+//
+// The slices are allocated in the FIFO order (the arena is used as a
+// ring), and the producer reclaims them in RingShare_alloc() from the
+// oldest one, as soon as their reference counts drop to zero. The
+// consumers only decrement the atomic reference counts, so any number of
+// them can release the slices concurrently with the producer.
+//
+typedef struct {
+    uint8_t *arena;      //!< the shared arena
+    uint32_t arena_len;  //!< length of the arena [bytes]
+    RingDesc *descs;     //!< descriptors (one per slice in use)
+    RingBufCtr n_descs;  //!< number of the descriptors
+
+    // the following are accessed only by the producer
+    uint32_t head;       //!< offset of the next allocated slice
+    uint32_t tail;       //!< offset of the oldest slice in use
+    RingBufCtr d_head;   //!< next descriptor to allocate
+    RingBufCtr d_tail;   //!< oldest descriptor in use
+    RingBufCtr n_used;   //!< number of the descriptors in use
+} RingShare;
+
+void RingShare_ctor(RingShare * const me, uint8_t arena[],
+                    uint32_t arena_len, RingDesc descs[], RingBufCtr n_descs);
+bool RingShare_alloc(RingShare * const me, uint32_t len,
+                     RingBufElement *ph);
+unsigned RingShare_publish(RingShare * const me, RingBufElement const h,
+                           RingBuf * const rings[], unsigned n_rings);
+void RingShare_release(RingShare * const me, RingBufElement const h);
+
+//! Pointer to the slice of the descriptor with the handle `h`
+static inline uint8_t *RingShare_ptr(RingShare const * const me,
+                                     RingBufElement const h)
+{
+    return &me->arena[me->descs[h].off];
+}
+//! Length of the slice of the descriptor with the handle `h` [bytes]
+static inline uint32_t RingShare_len(RingShare const * const me,
+                                     RingBufElement const h)
+{
+    return me->descs[h].len;
+}
+
+#endif // RING_SHARE_H
@@ -0,0 +1,223 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "ring_span.h"
+
+#if defined RING_SPAN_SCALAR
+    // portable scalar code only
+#elif defined __AVX2__
+    #define SPAN_AVX2
+    #include <immintrin.h>
+#elif defined __SSE2__
+    #define SPAN_SSE2
+    #include <emmintrin.h>
+#elif defined __aarch64__ && defined __ARM_NEON
+    #define SPAN_NEON
+    #include <arm_neon.h>
+#endif
+
+_Static_assert(sizeof(RingBufElement) == 1U,
+               "ring_span.c requires RingBufElement of one byte");
+
+static size_t span_find(uint8_t const *p, size_t n, uint8_t const c);
+static size_t span_count(uint8_t const *p, size_t n, uint8_t const c);
+static RingBufCtr find(RingBuf const * const me,
+                       RingBufCtr const tail, RingBufCtr const n,
+                       uint8_t const byte);
+
+//............................................................................
+// Returns the offset (from the tail) of the first occurrence of 'byte'
+// in the ring buffer, or RING_BUF_NOT_FOUND. Nothing is removed.
+RingBufCtr RingBuf_find(RingBuf * const me, uint8_t const byte) {
+    RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
+    RingBufCtr n_used = (head >= tail)
+                        ? (RingBufCtr)(head - tail)
+                        : (RingBufCtr)(me->end + head - tail);
+    return find(me, tail, n_used, byte);
+}
+//............................................................................
+// Returns the number of occurrences of 'byte' in the ring buffer.
+RingBufCtr RingBuf_count(RingBuf * const me, uint8_t const byte) {
+    RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
+    size_t cnt;
+    if (head >= tail) { // no wrap-around?
+        cnt = span_count(&me->buf[tail], (size_t)(head - tail), byte);
+    }
+    else {
+        cnt = span_count(&me->buf[tail], (size_t)(me->end - tail), byte)
+              + span_count(&me->buf[0], (size_t)head, byte);
+    }
+    return (RingBufCtr)cnt;
+}
+//............................................................................
+// Removes the bytes up to and including the first 'delim' into 'buf'
+// (one tail update) and returns their number. Nothing is removed when
+// 'delim' is not found: the function returns 0 when the frame can still
+// complete (fewer than 'n' bytes in a ring buffer that is not full), or
+// RING_BUF_NOT_FOUND when it cannot (the first 'n' bytes, or the whole
+// full ring buffer, hold no 'delim'), so the caller must drain or skip
+// the bytes, e.g., with RingBuf_get_n().
+RingBufCtr RingBuf_get_until(RingBuf * const me, uint8_t const delim,
+                             uint8_t buf[], RingBufCtr n)
+{
+    RingBufCtr tail = atomic_load_explicit(&me->tail, memory_order_relaxed);
+    RingBufCtr head = atomic_load_explicit(&me->head, memory_order_acquire);
+    RingBufCtr n_used = (head >= tail)
+                        ? (RingBufCtr)(head - tail)
+                        : (RingBufCtr)(me->end + head - tail);
+    bool const too_long = (n_used >= n)
+                          || (n_used == (RingBufCtr)(me->end - 1U));
+    if (n > n_used) {
+        n = n_used;
+    }
+    RingBufCtr const pos = find(me, tail, n, delim);
+    if (pos == RING_BUF_NOT_FOUND) {
+        return too_long ? RING_BUF_NOT_FOUND : 0U;
+    }
+    n = (RingBufCtr)(pos + 1U);
+    RingBufCtr const n_end = (RingBufCtr)(me->end - tail); // up to the end
+    if (n < n_end) { // no wrap-around?
+        memcpy(&buf[0], &me->buf[tail], n);
+        atomic_store_explicit(&me->tail, (RingBufCtr)(tail + n),
+                              memory_order_release);
+    }
+    else {
+        memcpy(&buf[0], &me->buf[tail], n_end);
+        memcpy(&buf[n_end], &me->buf[0], (RingBufCtr)(n - n_end));
+        RingBuf_wrap_tail_(me, (RingBufCtr)(n - n_end));
+    }
+    return n;
+}
+
+//............................................................................
+// offset of 'byte' in the 'n' bytes starting at 'tail' (with wrap-around)
+static RingBufCtr find(RingBuf const * const me,
+                       RingBufCtr const tail, RingBufCtr const n,
+                       uint8_t const byte)
+{
+    RingBufCtr const n_end = (RingBufCtr)(me->end - tail); // up to the end
+    size_t pos;
+    if (n <= n_end) { // no wrap-around?
+        pos = span_find(&me->buf[tail], (size_t)n, byte);
+    }
+    else {
+        pos = span_find(&me->buf[tail], (size_t)n_end, byte);
+        if (pos == (size_t)n_end) {
+            pos += span_find(&me->buf[0], (size_t)(n - n_end), byte);
+        }
+    }
+    return (pos < (size_t)n) ? (RingBufCtr)pos : RING_BUF_NOT_FOUND;
+}
+
+//............................................................................
+// index of the first 'c' in p[0..n), or n when not found
+static size_t span_find(uint8_t const *p, size_t n, uint8_t const c) {
+    size_t i = 0U;
+#if defined SPAN_AVX2
+    __m256i const v = _mm256_set1_epi8((char)c);
+    for (; i + 32U <= n; i += 32U) {
+        __m256i const x = _mm256_loadu_si256((__m256i const *)&p[i]);
+        uint32_t const m =
+            (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v));
+        if (m != 0U) {
+            return i + (size_t)__builtin_ctz(m);
+        }
+    }
+#elif defined SPAN_SSE2
+    __m128i const v = _mm_set1_epi8((char)c);
+    for (; i + 16U <= n; i += 16U) {
+        __m128i const x = _mm_loadu_si128((__m128i const *)&p[i]);
+        uint32_t const m =
+            (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, v));
+        if (m != 0U) {
+            return i + (size_t)__builtin_ctz(m);
+        }
+    }
+#elif defined SPAN_NEON
+    uint8x16_t const v = vdupq_n_u8(c);
+    for (; i + 16U <= n; i += 16U) {
+        uint8x16_t const eq = vceqq_u8(vld1q_u8(&p[i]), v);
+        // narrow the 16 byte-masks to 16 nibbles in a 64-bit word
+        uint64_t const m = vget_lane_u64(vreinterpret_u64_u8(
+            vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+        if (m != 0U) {
+            return i + ((size_t)__builtin_ctzll(m) >> 2);
+        }
+    }
+#endif
+    for (; i < n; ++i) { // the remaining bytes (or all on scalar CPUs)
+        if (p[i] == c) {
+            break;
+        }
+    }
+    return i;
+}
+//............................................................................
+// number of the bytes 'c' in p[0..n)
+static size_t span_count(uint8_t const *p, size_t n, uint8_t const c) {
+    size_t i = 0U;
+    size_t cnt = 0U;
+#if defined SPAN_AVX2
+    __m256i const v = _mm256_set1_epi8((char)c);
+    for (; i + 32U <= n; i += 32U) {
+        __m256i const x = _mm256_loadu_si256((__m256i const *)&p[i]);
+        cnt += (size_t)__builtin_popcount(
+            (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, v)));
+    }
+#elif defined SPAN_SSE2
+    __m128i const v = _mm_set1_epi8((char)c);
+    for (; i + 16U <= n; i += 16U) {
+        __m128i const x = _mm_loadu_si128((__m128i const *)&p[i]);
+        cnt += (size_t)__builtin_popcount(
+            (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(x, v)));
+    }
+#elif defined SPAN_NEON
+    uint8x16_t const v = vdupq_n_u8(c);
+    while (i + 16U <= n) {
+        // byte counters in 'acc' can take up to 255 blocks
+        uint8x16_t acc = vdupq_n_u8(0U);
+        for (unsigned k = 0U; (k < 255U) && (i + 16U <= n); ++k, i += 16U) {
+            acc = vsubq_u8(acc, vceqq_u8(vld1q_u8(&p[i]), v));
+        }
+        cnt += (size_t)vaddlvq_u8(acc);
+    }
+#endif
+    for (; i < n; ++i) { // the remaining bytes (or all on scalar CPUs)
+        cnt += (p[i] == c) ? 1U : 0U;
+    }
+    return cnt;
+}
@@ -0,0 +1,61 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_SPAN_H
+#define RING_SPAN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+//! Span-level operations on byte ring buffers (consumer side)
+//
+// @details
+// The functions below scan the whole readable region of the ring buffer
+// (up to two contiguous spans, when the data wraps around the end) in
+// one pass, 16 or 32 bytes at a time with SSE2, AVX2 (e.g., -mavx2), or
+// AArch64 NEON, and with the portable scalar code on other CPUs (or when
+// RING_SPAN_SCALAR is defined). They require `RingBufElement` of one
+// byte and must be called only by the consumer. The bulk copy of the
+// spans into the caller's buffer is RingBuf_get_n() in ring_buf.h.
+//
+
+//! Returned by RingBuf_find() when the byte is not in the ring buffer,
+//! and by RingBuf_get_until() when the frame cannot fit in the caller's
+//! buffer (or in the full ring buffer) and must be drained otherwise
+#define RING_BUF_NOT_FOUND ((RingBufCtr)~(RingBufCtr)0)
+
+RingBufCtr RingBuf_find(RingBuf * const me, uint8_t const byte);
+RingBufCtr RingBuf_count(RingBuf * const me, uint8_t const byte);
+RingBufCtr RingBuf_get_until(RingBuf * const me, uint8_t const delim,
+                             uint8_t buf[], RingBufCtr n);
+
+#endif // RING_SPAN_H
@@ -0,0 +1,106 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_spill.h"
+#include "ring_buf_host.h"
+
+static bool spill_empty(RingBuf const * const rb);
+
+//............................................................................
+// Returns false when the spill file cannot be mapped.
+bool RingSpill_ctor(RingSpill * const me, RingBuf * const mem,
+                    char const *path, RingBufCtr const spill_len)
+{
+    bool recovered; // elements left in the spill file are drained first
+    me->mem       = mem;
+    me->spill     = RingBuf_host_persist(path, spill_len, &recovered);
+    me->n_spilled = 0U;
+    me->n_drops   = 0U;
+    return me->spill != (RingBufPersist *)0;
+}
+//............................................................................
+void RingSpill_xtor(RingSpill * const me) {
+    if (me->spill != (RingBufPersist *)0) {
+        RingBuf_host_persist_close(me->spill);
+        me->spill = (RingBufPersist *)0;
+    }
+}
+//............................................................................
+// Called only by the producer.
+bool RingSpill_put(RingSpill * const me, RingBufElement const el) {
+    RingBuf * const spill = &me->spill->rb;
+    // put into 'mem' only while nothing newer waits in the spill
+    if (spill_empty(spill) && RingBuf_put(me->mem, el)) {
+        return true;
+    }
+    if (RingBuf_put(spill, el)) {
+        ++me->n_spilled;
+        return true;
+    }
+    ++me->n_drops;
+    return false;
+}
+//............................................................................
+// Called only by the consumer.
+bool RingSpill_get(RingSpill * const me, RingBufElement *pel) {
+    RingBuf * const spill = &me->spill->rb;
+    // the spill head *before* checking 'mem' bounds the elements that
+    // are older than anything the producer can put into 'mem' later
+    RingBufCtr const head =
+        atomic_load_explicit(&spill->head, memory_order_acquire);
+    if (RingBuf_get(me->mem, pel)) {
+        return true;
+    }
+    if (head == atomic_load_explicit(&spill->tail, memory_order_relaxed)) {
+        return false; // nothing (old enough) in the spill
+    }
+    return RingBuf_get(spill, pel);
+}
+//............................................................................
+RingBufCtr RingSpill_num_spilled(RingSpill const * const me) {
+    RingBuf const * const spill = &me->spill->rb;
+    RingBufCtr const head =
+        atomic_load_explicit(&spill->head, memory_order_acquire);
+    RingBufCtr const tail =
+        atomic_load_explicit(&spill->tail, memory_order_acquire);
+    return (head >= tail) ? (RingBufCtr)(head - tail)
+                          : (RingBufCtr)(spill->end - tail + head);
+}
+
+//............................................................................
+static bool spill_empty(RingBuf const * const rb) {
+    // the producer owns the head, so the spill can only become empty
+    // later (by the consumer), never non-empty behind its back
+    return atomic_load_explicit(&rb->head, memory_order_relaxed)
+           == atomic_load_explicit(&rb->tail, memory_order_acquire);
+}
@@ -0,0 +1,75 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef RING_SPILL_H
+#define RING_SPILL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_buf_persist.h"
+
+//! Ring buffer with the overflow into a spill file (host computers)
+//
+// @details
+// When the in-memory ring buffer `mem` is full (e.g., the consumer stalls
+// during a burst), RingSpill_put() appends the elements sequentially to
+// the spill ring buffer in a memory-mapped file (see RingBuf_host_persist()
+// in ring_buf_host.h) instead of dropping them. The spill file needs
+// only disk space, not RAM, for the worst-case burst.
+//
+// The FIFO order is preserved, because the producer keeps spilling as
+// long as the spill is not empty, so all elements in `mem` are always
+// older than the elements in the spill. The consumer drains `mem` first
+// and then the spill, which it bounds by the spill head loaded *before*
+// checking `mem` (an element that the producer spills after refilling
+// `mem` behind the consumer's back is left for the next call).
+//
+// The spill file is a ::RingBufPersist, so the spilled elements also
+// survive the crash of the process and are drained first after restart.
+// The spill length is limited by RingBufCtr (e.g., RING_BUF_CTR_SIZE=4
+// for bursts of millions of elements).
+//
+typedef struct {
+    RingBuf *mem;           //!< the in-memory ring buffer
+    RingBufPersist *spill;  //!< the spill ring buffer (memory-mapped file)
+    uint32_t n_spilled;     //!< number of elements put into the spill
+    uint32_t n_drops;       //!< number of elements dropped (both full)
+} RingSpill;
+
+bool RingSpill_ctor(RingSpill * const me, RingBuf * const mem,
+                    char const *path, RingBufCtr const spill_len);
+void RingSpill_xtor(RingSpill * const me);
+bool RingSpill_put(RingSpill * const me, RingBufElement const el);
+bool RingSpill_get(RingSpill * const me, RingBufElement *pel);
+RingBufCtr RingSpill_num_spilled(RingSpill const * const me);
+
+#endif // RING_SPILL_H
@@ -0,0 +1,191 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef SPSC_RING_HPP
+#define SPSC_RING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace lfrb {
+
+//! Single-producer, single-consumer ring buffer of elements of type T
+//
+// @details
+// SpscRing is the C++17 counterpart of the ::RingBuf and uses the same
+// head/tail algorithm and memory orders as ring_buf.c, but:
+// - the capacity N is a compile-time constant (N elements can be stored,
+//   because the storage has N + 1 slots, one of which is always empty);
+// - the elements are constructed in place (emplace()) and moved out
+//   (try_pop(), consume_all()), so move-only types are supported;
+// - the elements left in the ring are destroyed with the ring.
+//
+// The same lock-free restrictions apply as for the ::RingBuf (only one
+// producer and only one consumer).
+//
+template<typename T, std::size_t N>
+class SpscRing {
+    static_assert(N > 0U, "SpscRing capacity must be positive");
+
+public:
+    using value_type = T;
+    using size_type  = std::size_t;
+
+    SpscRing() noexcept = default;
+    SpscRing(SpscRing const &) = delete;
+    SpscRing &operator=(SpscRing const &) = delete;
+
+    ~SpscRing() {
+        consume_all([](T &&) {}); // destroy the remaining elements
+    }
+
+    static constexpr size_type capacity() noexcept { return N; }
+
+    //! construct an element in place (producer only)
+    template<typename... Args>
+    bool emplace(Args &&... args)
+        noexcept(std::is_nothrow_constructible_v<T, Args &&...>)
+    {
+        size_type const head = m_head.load(std::memory_order_relaxed);
+        size_type const next = inc(head);
+        if (next == m_tail.load(std::memory_order_acquire)) {
+            return false; // buffer full
+        }
+        ::new (static_cast<void *>(slot(head))) T(std::forward<Args>(args)...);
+        m_head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    //! insert a copy of an element (producer only)
+    bool try_push(T const &el) { return emplace(el); }
+
+    //! insert an element by moving it (producer only)
+    bool try_push(T &&el) { return emplace(std::move(el)); }
+
+    //! move the oldest element out of the ring (consumer only)
+    bool try_pop(T &el) {
+        size_type const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return false; // buffer empty
+        }
+        T * const p = slot(tail);
+        el = std::move(*p);
+        p->~T();
+        m_tail.store(inc(tail), std::memory_order_release);
+        return true;
+    }
+
+    //! move the oldest element out of the ring (consumer only)
+    std::optional<T> try_pop() {
+        size_type const tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_head.load(std::memory_order_acquire)) {
+            return std::nullopt; // buffer empty
+        }
+        T * const p = slot(tail);
+        std::optional<T> el(std::move(*p));
+        p->~T();
+        m_tail.store(inc(tail), std::memory_order_release);
+        return el;
+    }
+
+    //! process all elements available at the time of the call with the
+    //! handler invoked as handler(T &&) (consumer only)
+    //
+    // @details
+    // This is the counterpart of RingBuf_process_all(), but the handler
+    // can be a lambda, which the compiler can inline.
+    //
+    template<typename Handler>
+    size_type consume_all(Handler &&handler) {
+        size_type tail = m_tail.load(std::memory_order_relaxed);
+        size_type const head = m_head.load(std::memory_order_acquire);
+        size_type n = 0U;
+        while (head != tail) { // buffer NOT empty?
+            T * const p = slot(tail);
+            handler(std::move(*p));
+            p->~T();
+            tail = inc(tail);
+            m_tail.store(tail, std::memory_order_release);
+            ++n;
+        }
+        return n;
+    }
+
+    //! number of free slots (producer or consumer)
+    size_type num_free() const noexcept {
+        size_type const head = m_head.load(std::memory_order_acquire);
+        size_type const tail = m_tail.load(std::memory_order_relaxed);
+        if (head == tail) { // buffer empty?
+            return N;
+        }
+        else if (head < tail) {
+            return tail - head - 1U;
+        }
+        else {
+            return N + 1U + tail - head - 1U;
+        }
+    }
+
+    bool empty() const noexcept {
+        return m_head.load(std::memory_order_acquire)
+               == m_tail.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr size_type END = N + 1U; // number of slots
+
+    static constexpr size_type inc(size_type const i) noexcept {
+        return (i + 1U == END) ? 0U : (i + 1U);
+    }
+
+    T *slot(size_type const i) noexcept {
+        return std::launder(reinterpret_cast<T *>(&m_sto[i]));
+    }
+
+    //! uninitialized storage for the elements
+    struct Slot {
+        alignas(T) unsigned char bytes[sizeof(T)];
+    };
+    Slot m_sto[END];
+
+    //! atomic index to where next element will be inserted
+    std::atomic<size_type> m_head{0U};
+
+    //! atomic index to where next element will be removed
+    std::atomic<size_type> m_tail{0U};
+};
+
+} // namespace lfrb
+
+#endif // SPSC_RING_HPP
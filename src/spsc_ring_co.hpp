@@ -0,0 +1,209 @@
+//============================================================================
+// Lock-Free Ring Buffer (LFRB) for embedded systems
+// GitHub: https://github.com/QuantumLeaps/lock-free-ring-buffer
+//
+//                    Q u a n t u m  L e a P s
+//                    ------------------------
+//                    Modern Embedded Software
+//
+// Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+//
+// SPDX-License-Identifier: MIT
+//
+// Permission is hereby granted, free of charge, to any person obtaining a
+// copy of this software and associated documentation files (the "Software"),
+// to deal in the Software without restriction, including without limitation
+// the rights to use, copy, modify, merge, publish, distribute, sublicense,
+// and/or sell copies of the Software, and to permit persons to whom the
+// Software is furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//============================================================================
+#ifndef SPSC_RING_CO_HPP
+#define SPSC_RING_CO_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <optional>
+#include <utility>
+
+#include "spsc_ring.hpp"
+
+namespace lfrb {
+
+//! SpscRing with C++20 coroutine awaitables for push and pop
+//
+// @details
+// `co_await ring.push(x)` suspends the producer coroutine while the ring
+// is full and `co_await ring.pop()` suspends the consumer coroutine while
+// the ring is empty. A suspended coroutine is resumed directly by the other
+// side, at the put/get that made room/data available. In other words, the
+// resumed coroutine continues in the context (thread) of the other side,
+// like a task readied by an ISR. No thread ever blocks and nothing is
+// allocated on the heap (the awaitables live in the coroutine frames).
+//
+// The fast path (ring not full/empty) does not suspend at all. The only
+// extra cost over SpscRing is a sequentially-consistent fence per put/get,
+// which is needed to check for a waiting coroutine without lost wake-ups.
+//
+// The same lock-free restrictions apply as for SpscRing (one producer
+// coroutine and one consumer coroutine).
+//
+template<typename T, std::size_t N>
+class AsyncSpscRing {
+public:
+    //! awaitable returned from push()
+    class PushAwaiter {
+    public:
+        bool await_ready() {
+            m_done = m_ring.m_ring.try_push(std::move(m_el));
+            if (m_done) {
+                m_ring.notify(m_ring.m_pop_waiter);
+            }
+            return m_done;
+        }
+        bool await_suspend(std::coroutine_handle<> h) {
+            // NOTE: the awaiter might be gone as soon as h is registered
+            AsyncSpscRing &r = m_ring;
+            return wait(r.m_push_waiter, h,
+                        [&r]() { return r.m_ring.num_free() != 0U; });
+        }
+        void await_resume() {
+            if (!m_done) { // resumed because there is room now
+                (void)m_ring.m_ring.try_push(std::move(m_el));
+                m_ring.notify(m_ring.m_pop_waiter);
+            }
+        }
+
+    private:
+        friend class AsyncSpscRing;
+        PushAwaiter(AsyncSpscRing &ring, T &&el)
+          : m_ring(ring), m_el(std::move(el))
+        {}
+        AsyncSpscRing &m_ring;
+        T m_el;
+        bool m_done = false;
+    };
+
+    //! awaitable returned from pop()
+    class PopAwaiter {
+    public:
+        bool await_ready() {
+            m_el = m_ring.m_ring.try_pop();
+            if (m_el.has_value()) {
+                m_ring.notify(m_ring.m_push_waiter);
+                return true;
+            }
+            return false;
+        }
+        bool await_suspend(std::coroutine_handle<> h) {
+            // NOTE: the awaiter might be gone as soon as h is registered
+            AsyncSpscRing &r = m_ring;
+            return wait(r.m_pop_waiter, h,
+                        [&r]() { return !r.m_ring.empty(); });
+        }
+        T await_resume() {
+            if (!m_el.has_value()) { // resumed because there is data now
+                m_el = m_ring.m_ring.try_pop();
+                m_ring.notify(m_ring.m_push_waiter);
+            }
+            return std::move(*m_el);
+        }
+
+    private:
+        friend class AsyncSpscRing;
+        explicit PopAwaiter(AsyncSpscRing &ring) : m_ring(ring) {}
+        AsyncSpscRing &m_ring;
+        std::optional<T> m_el;
+    };
+
+    AsyncSpscRing() noexcept = default;
+    AsyncSpscRing(AsyncSpscRing const &) = delete;
+    AsyncSpscRing &operator=(AsyncSpscRing const &) = delete;
+
+    static constexpr std::size_t capacity() noexcept { return N; }
+
+    //! `co_await push(el)` inserts el, suspends while full (producer only)
+    PushAwaiter push(T el) { return PushAwaiter(*this, std::move(el)); }
+
+    //! `co_await pop()` removes an element, suspends while empty
+    //! (consumer only)
+    PopAwaiter pop() { return PopAwaiter(*this); }
+
+    //! non-suspending insert, e.g., for a producer outside of coroutines
+    bool try_push(T &&el) {
+        if (m_ring.try_push(std::move(el))) {
+            notify(m_pop_waiter);
+            return true;
+        }
+        return false;
+    }
+
+    //! non-suspending remove, e.g., for a consumer outside of coroutines
+    std::optional<T> try_pop() {
+        std::optional<T> el = m_ring.try_pop();
+        if (el.has_value()) {
+            notify(m_push_waiter);
+        }
+        return el;
+    }
+
+    std::size_t num_free() const noexcept { return m_ring.num_free(); }
+
+private:
+    //! resume the coroutine waiting on the other side (if any)
+    static void notify(std::atomic<void *> &waiter) {
+        // pairs with the fence in wait(): either the waiter sees the
+        // put/get or this check sees the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiter.load(std::memory_order_relaxed) != nullptr) {
+            void * const addr =
+                waiter.exchange(nullptr, std::memory_order_acq_rel);
+            if (addr != nullptr) {
+                std::coroutine_handle<>::from_address(addr).resume();
+            }
+        }
+    }
+
+    //! register the coroutine h as waiting, return false if h must not
+    //! be suspended, because the awaited condition became true meanwhile
+    template<typename Cond>
+    static bool wait(std::atomic<void *> &waiter, std::coroutine_handle<> h,
+                     Cond const &cond)
+    {
+        // release: pairs with the exchange() in notify(), so the frame of
+        // h (and the awaiter fields) are visible to the resuming thread
+        waiter.store(h.address(), std::memory_order_release);
+        // pairs with the fence in notify(): either this check sees the
+        // put/get or notify() sees the waiter
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (cond()) {
+            // take the registration back, unless the other side
+            // has already taken it and is going to resume h
+            if (waiter.exchange(nullptr, std::memory_order_acq_rel)
+                != nullptr)
+            {
+                return false; // don't suspend
+            }
+        }
+        return true;
+    }
+
+    SpscRing<T, N> m_ring;
+    std::atomic<void *> m_push_waiter{nullptr}; //!< suspended producer
+    std::atomic<void *> m_pop_waiter{nullptr};  //!< suspended consumer
+};
+
+} // namespace lfrb
+
+#endif // SPSC_RING_CO_HPP
@@ -0,0 +1,171 @@
+/*============================================================================
+* Host benchmark of the lock-free ring buffer
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+
+#include "ring_buf.h"
+#include "ring_buf_host.h"
+
+/* usage: bench_ring_buf [ring-length [number-of-transfers]] */
+
+static RingBuf rb;
+static uint64_t n_xfer;
+static uint64_t sum_out;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+static void report(char const *what, uint64_t n, double sec) {
+    printf("%-28s %12llu ops %8.3f s %9.2f Mops/s %7.2f ns/op\n",
+           what, (unsigned long long)n, sec,
+           (double)n / sec * 1e-6, sec * 1e9 / (double)n);
+}
+
+/*..........................................................................*/
+static void *producer(void *arg) {
+    (void)arg;
+    for (uint64_t i = 0U; i < n_xfer; ++i) {
+        while (!RingBuf_put(&rb, (RingBufElement)i)) {
+        }
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static void *consumer(void *arg) {
+    (void)arg;
+    uint64_t sum = 0U;
+    for (uint64_t i = 0U; i < n_xfer; ++i) {
+        RingBufElement el;
+        while (!RingBuf_get(&rb, &el)) {
+        }
+        sum += el;
+    }
+    sum_out = sum;
+    return (void *)0;
+}
+
+/*..........................................................................*/
+/* run all benchmarks on the ring buffer 'rb' with the given storage */
+static bool bench(char const *sto_name) {
+    printf("storage: %s\n", sto_name);
+
+    /* single thread: fill the whole ring, then drain it (memory bound) */
+    double t0 = now_sec();
+    uint64_t n = 0U;
+    while (RingBuf_put(&rb, (RingBufElement)n)) {
+        ++n;
+    }
+    double t1 = now_sec();
+    RingBufElement el;
+    while (RingBuf_get(&rb, &el)) {
+    }
+    double t2 = now_sec();
+    report("fill (1 thread)", n, t1 - t0);
+    report("drain (1 thread)", n, t2 - t1);
+
+    /* two threads: producer/consumer streaming through the ring */
+    pthread_t prod;
+    pthread_t cons;
+    t0 = now_sec();
+    pthread_create(&cons, (pthread_attr_t *)0, &consumer, (void *)0);
+    pthread_create(&prod, (pthread_attr_t *)0, &producer, (void *)0);
+    pthread_join(prod, (void **)0);
+    pthread_join(cons, (void **)0);
+    t1 = now_sec();
+    report("stream (2 threads)", n_xfer, t1 - t0);
+
+    /* the consumer must see exactly what the producer has sent */
+    uint64_t sum_in = 0U;
+    for (uint64_t i = 0U; i < n_xfer; ++i) {
+        sum_in += (RingBufElement)i;
+    }
+    if (sum_in != sum_out) {
+        fprintf(stderr, "checksum mismatch\n");
+        return false;
+    }
+    return true;
+}
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    /* default: the largest ring, but not more than 256M elements */
+    uint64_t len = (uint64_t)((RingBufCtr)~(RingBufCtr)0);
+    if (len > (1U << 28)) {
+        len = (1U << 28);
+    }
+    if (argc > 1) {
+        len = strtoull(argv[1], (char **)0, 0);
+    }
+    if (len > (uint64_t)((RingBufCtr)~(RingBufCtr)0)) {
+        fprintf(stderr, "ring length %llu exceeds the RingBufCtr range "
+                "(RING_BUF_CTR_SIZE=%u)\n",
+                (unsigned long long)len, (unsigned)RING_BUF_CTR_SIZE);
+        return -1;
+    }
+    if (len < 2U) {
+        fprintf(stderr, "ring length must be at least 2\n");
+        return -1;
+    }
+    n_xfer = (argc > 2) ? strtoull(argv[2], (char **)0, 0) : 4U * len;
+
+    printf("ring: %llu elements, %llu bytes, RingBufCtr: %u bytes\n",
+           (unsigned long long)len,
+           (unsigned long long)(len * sizeof(RingBufElement)),
+           (unsigned)sizeof(RingBufCtr));
+
+    /* ordinary malloc()'ed storage */
+    RingBufElement *sto = malloc((size_t)len * sizeof(RingBufElement));
+    if (sto == (RingBufElement *)0) {
+        fprintf(stderr, "cannot allocate %llu elements\n",
+                (unsigned long long)len);
+        return -1;
+    }
+    RingBuf_ctor(&rb, sto, (RingBufCtr)len);
+    bool ok = bench("malloc");
+    free(sto);
+
+    /* storage allocated by RingBuf_host_ctor() */
+    static struct {
+        char const *name;
+        RingBufHostCfg cfg;
+    } const host_sto[] = {
+        { "THP",
+          { RING_BUF_PAGES_THP,     false, RING_BUF_NUMA_ANY   } },
+        { "THP, prefault, local NUMA node",
+          { RING_BUF_PAGES_THP,     true,  RING_BUF_NUMA_LOCAL } },
+        { "HUGETLB, prefault, local NUMA node",
+          { RING_BUF_PAGES_HUGETLB, true,  RING_BUF_NUMA_LOCAL } },
+    };
+    for (unsigned i = 0U; ok && (i < sizeof(host_sto)/sizeof(host_sto[0]));
+         ++i)
+    {
+        if (!RingBuf_host_ctor(&rb, (RingBufCtr)len, &host_sto[i].cfg)) {
+            fprintf(stderr, "RingBuf_host_ctor() failed\n");
+            return -1;
+        }
+        ok = bench(host_sto[i].name);
+        RingBuf_host_xtor(&rb, &host_sto[i].cfg);
+    }
+    return ok ? 0 : -1;
+}
@@ -0,0 +1,20 @@
+/*============================================================================
+* ET: embedded test; board support package (BSP) extensions
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+*
+* SPDX-License-Identifier: MIT
+============================================================================*/
+#ifndef BSP_H
+#define BSP_H
+
+#include "ring_buf.h"
+
+/* read up to 'n' characters received by the interrupt-driven USART */
+RingBufCtr BSP_uartRead(RingBufElement data[], RingBufCtr n);
+
+#endif /* BSP_H */
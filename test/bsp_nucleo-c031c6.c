@@ -31,6 +31,8 @@
 
 #include "stm32c0xx.h"  /* CMSIS-compliant header file for the MCU used */
 /* add other drivers if necessary... */
+#include "uart_drv.h"     /* ring-buffered UART driver */
+#include "bsp.h"
 
 /* Local-scope objects -----------------------------------------------------*/
 /* LED pins available on the board (just one user LED LD2--Green on PA.5) */
@@ -52,6 +54,11 @@ static uint16_t const UARTPrescTable[12] = {
     1U, 2U, 4U, 6U, 8U, 10U, 12U, 16U, 32U, 64U, 128U, 256U
 };
 
+/* USART2 driver with the TX/RX ring buffers drained/filled by the ISR */
+static UartDrv l_uart;
+static RingBufElement l_uart_tx_sto[256];
+static RingBufElement l_uart_rx_sto[64];
+
 
 /*..........................................................................*/
 void ET_onInit(int argc, char *argv[]) {
@@ -88,22 +95,89 @@ void ET_onInit(int argc, char *argv[]) {
     GPIOA->PUPDR  &= ~(( 3U << 2U*USART2_RX_PIN) | ( 3U << 2U*USART2_TX_PIN));
     GPIOA->PUPDR  |=  (( 1U << 2U*USART2_RX_PIN) | ( 1U << 2U*USART2_TX_PIN));
 
+    UartDrv_ctor(&l_uart,
+                 l_uart_tx_sto, ARRAY_NELEM(l_uart_tx_sto),
+                 l_uart_rx_sto, ARRAY_NELEM(l_uart_rx_sto));
+
+    /* USART2 on STM32C031 is a basic USART without the FIFO mode (see
+    * RM0490, USART implementation), so the driver gets one TXE/RXNE
+    * interrupt per character. (USART1 has the FIFO with the TXFT/RXFT
+    * threshold interrupts, which the driver batches into bursts.)
+    */
     USART2->BRR  = UART_DIV_SAMPLING16(SystemCoreClock, 115200U, 0U);
-    USART2->CR1  = USART_CR1_TE_Msk | USART_CR1_RE_Msk
-                   | USART_CR1_RXNEIE_RXFNEIE_Msk
-                   | USART_CR1_UE_Msk;
     USART2->CR2  = 0x00000000U;
     USART2->CR3  = 0x00000000U;
+    USART2->CR1  = USART_CR1_TE_Msk | USART_CR1_RE_Msk
+                   | USART_CR1_RXNEIE_RXFNEIE
+                   | USART_CR1_UE_Msk;
+    NVIC_EnableIRQ(USART2_IRQn);
+}
+/*..........................................................................*/
+/* USART2 registers for the shared UartDrv_isr() (no FIFO: TXE/RXNE) */
+static bool usart2_tx_pending(void) {
+    return ((USART2->ISR & USART_ISR_TXE_TXFNF) != 0U)
+           && ((USART2->CR1 & USART_CR1_TXEIE_TXFNFIE) != 0U);
+}
+static void usart2_tx_write(RingBufElement const el) {
+    USART2->TDR = el;
+}
+static void usart2_tx_stop(void) {
+    USART2->CR1 &= ~USART_CR1_TXEIE_TXFNFIE;
+}
+static bool usart2_rx_pending(void) {
+    if ((USART2->ISR & USART_ISR_ORE) != 0U) { /* overrun: clear it, */
+        USART2->ICR = USART_ICR_ORECF; /* or RXNEIE would fire forever */
+    }
+    return (USART2->ISR & USART_ISR_RXNE_RXFNE) != 0U;
+}
+static bool usart2_rx_read(RingBufElement *pel) {
+    if ((USART2->ISR & USART_ISR_RXNE_RXFNE) == 0U) {
+        return false;
+    }
+    *pel = (RingBufElement)USART2->RDR;
+    return true;
+}
+static UartPort const l_usart2_port = {
+    1U, /* USART2 on STM32C031 has no FIFO */
+    &usart2_tx_pending, &usart2_tx_write, &usart2_tx_stop,
+    &usart2_rx_pending, &usart2_rx_read
+};
+/*..........................................................................*/
+void USART2_IRQHandler(void); /* prototype */
+void USART2_IRQHandler(void) {
+    UartDrv_isr(&l_uart, &l_usart2_port);
+}
+/*..........................................................................*/
+RingBufCtr BSP_uartRead(RingBufElement data[], RingBufCtr n) {
+    return UartDrv_read(&l_uart, data, n);
 }
 /*..........................................................................*/
 void ET_onPrintChar(char const ch) {
-    while ((USART2->ISR & (1U << 7U)) == 0U) { /* while TXE not empty */
+    RingBufElement const el = (RingBufElement)ch;
+    while (UartDrv_write(&l_uart, &el, 1U) == 0U) {
+        /* TX ring buffer full: wait for the ISR to drain it */
     }
-    USART2->TDR = ch; /* put ch into the DR register */
+    __disable_irq(); /* CR1 is also modified in the ISR */
+    USART2->CR1 |= USART_CR1_TXEIE_TXFNFIE; /* (re)start the TX interrupts */
+    __enable_irq();
 }
 /*..........................................................................*/
 void ET_onExit(int err) {
     (void)err;
+    /* flush the TX ring buffer by polling, because ET_onExit() can be
+    * called from assert_failed() in an exception handler, where the
+    * USART2 interrupt cannot run
+    */
+    __disable_irq();
+    RingBufElement el;
+    while (UartDrv_txIsr(&l_uart, &el, 1U) != 0U) {
+        while ((USART2->ISR & USART_ISR_TXE_TXFNF) == 0U) { /* TDR full */
+        }
+        USART2->TDR = el;
+    }
+    while ((USART2->ISR & USART_ISR_TC) == 0U) { /* last frame sent */
+    }
+    __enable_irq();
     /* blink the on-board LED2... */
     for (;;) {
         unsigned volatile ctr;
@@ -0,0 +1,239 @@
+/*============================================================================
+* Cost of the RingBuf operations in an ISR on Cortex-M0+
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+
+/* Two ways of running this bare-metal program (see isr_cost.mak):
+*
+* ISR_COST_QEMU: under qemu-system-arm (machine 'microbit', Cortex-M0)
+* with the TCG "insn" plugin. The program executes one operation
+* 'n' times and exits through semihosting; isr_cost.mak subtracts the
+* instruction count of the same run without the operation (do_op = 0),
+* which gives the exact number of instructions per operation. QEMU is
+* not cycle-accurate, so it reports instructions only.
+*
+* otherwise: on the NUCLEO-C031C6 board (Cortex-M0+), where the SysTick
+* counts the CPU cycles of every operation. The cycles (min/max over
+* the repetitions) are printed over USART2 (polling, 115200 baud).
+*/
+
+/* ring buffer length for the measurements (wrap-around at index 7) */
+#define LEN 8U
+
+static RingBufElement buf[LEN];
+static RingBuf rb;
+static RingBufElement burst[LEN];
+
+/* the operations in their worst-case (or typical) state ------------------*/
+typedef struct {
+    char const *name;
+    void (*setup)(void);
+    void (*op)(void);
+} IsrCostOp;
+
+static void set_idx(RingBufCtr const head, RingBufCtr const tail) {
+    atomic_store_explicit(&rb.head, head, memory_order_relaxed);
+    atomic_store_explicit(&rb.tail, tail, memory_order_relaxed);
+}
+static void setup_empty(void)     { set_idx(0U, 0U); }
+static void setup_put_wrap(void)  { set_idx(LEN - 1U, 3U); }
+static void setup_full(void)      { set_idx(2U, 3U); }
+static void setup_one(void)       { set_idx(1U, 0U); }
+static void setup_get_wrap(void)  { set_idx(3U, LEN - 1U); }
+static void setup_n_wrap(void)    { set_idx(LEN - 2U, LEN - 2U); }
+static void setup_get_n_wrap(void) { set_idx(3U, LEN - 3U); }
+
+static void op_put(void)   { (void)RingBuf_put(&rb, 0xAAU); }
+static void op_get(void)   { RingBufElement el; (void)RingBuf_get(&rb, &el); }
+static void op_put_n(void) { (void)RingBuf_put_n(&rb, burst, 4U); }
+static void op_get_n(void) { (void)RingBuf_get_n(&rb, burst, 4U); }
+static void op_num_free(void) { (void)RingBuf_num_free(&rb); }
+
+static IsrCostOp const l_ops[] = {
+    { "put",              &setup_empty,      &op_put      },
+    { "put wrap-around",  &setup_put_wrap,   &op_put      },
+    { "put full",         &setup_full,       &op_put      },
+    { "get",              &setup_one,        &op_get      },
+    { "get wrap-around",  &setup_get_wrap,   &op_get      },
+    { "get empty",        &setup_empty,      &op_get      },
+    { "put_n 4 wrap",     &setup_n_wrap,     &op_put_n    },
+    { "get_n 4 wrap",     &setup_get_n_wrap, &op_get_n    },
+    { "num_free",         &setup_one,        &op_num_free },
+};
+
+#ifdef ISR_COST_QEMU
+/*==========================================================================*/
+/* semihosting (ARM "bkpt 0xAB") */
+#define SYS_WRITE0      0x04U
+#define SYS_GET_CMDLINE 0x15U
+#define SYS_EXIT        0x18U
+#define ADP_Stopped_ApplicationExit 0x20026U
+
+static uint32_t semihost(uint32_t op, void const *arg) {
+    register uint32_t r0 __asm("r0") = op;
+    register void const *r1 __asm("r1") = arg;
+    __asm volatile ("bkpt 0xAB" : "+r" (r0) : "r" (r1) : "memory");
+    return r0;
+}
+static uint32_t parse_dec(char const **ps) {
+    uint32_t n = 0U;
+    while (**ps == ' ') {
+        ++*ps;
+    }
+    for (; (**ps >= '0') && (**ps <= '9'); ++*ps) {
+        n = n*10U + (uint32_t)(**ps - '0');
+    }
+    return n;
+}
+
+/* command line: "<elf-path> <op-index> <repetitions> <do_op>", where
+* QEMU passes the -kernel file name first, followed by the -append string
+*/
+int main(void) {
+    static char cmdline[256];
+    struct { char *buf; uint32_t len; } cmd = { cmdline, sizeof(cmdline) };
+    uint32_t op = 0U;
+    uint32_t n = 0U;
+    uint32_t volatile do_op = 0U;
+    if (semihost(SYS_GET_CMDLINE, &cmd) == 0U) {
+        char const *p = cmdline;
+        while (*p == ' ') { /* skip the program name (argv[0]) */
+            ++p;
+        }
+        while ((*p != ' ') && (*p != '\0')) {
+            ++p;
+        }
+        op    = parse_dec(&p);
+        n     = parse_dec(&p);
+        do_op = parse_dec(&p);
+    }
+    if (op >= sizeof(l_ops)/sizeof(l_ops[0])) {
+        semihost(SYS_WRITE0, "isr_cost: invalid operation index\n");
+        op = 0U;
+        n  = 0U;
+    }
+    RingBuf_ctor(&rb, buf, LEN);
+    for (uint32_t i = 0U; i < n; ++i) {
+        (*l_ops[op].setup)();
+        if (do_op != 0U) {
+            (*l_ops[op].op)();
+        }
+    }
+    /* on AArch32 the reason code is passed directly (no parameter block) */
+    semihost(SYS_EXIT, (void const *)ADP_Stopped_ApplicationExit);
+    for (;;) {
+    }
+}
+
+/* minimal startup code for the 'microbit' machine (no .data/.bss init
+* needed, all variables are initialized at run time)
+*/
+extern uint32_t __stack_end__;
+void Reset_Handler(void);
+void Reset_Handler(void) {
+    (void)main();
+}
+__attribute__ ((section(".isr_vector"), used))
+static void const * const l_vectors[] = {
+    &__stack_end__,
+    (void const *)&Reset_Handler,
+};
+
+#else /* measurement with SysTick on the NUCLEO-C031C6 board */
+/*==========================================================================*/
+#include "stm32c0xx.h"  /* CMSIS-compliant header file for the MCU used */
+
+#define N_REPS 16U
+
+static void print_str(char const *str) {
+    for (; *str != '\0'; ++str) {
+        while ((USART2->ISR & USART_ISR_TXE_TXFNF) == 0U) {
+        }
+        USART2->TDR = (uint8_t)*str;
+    }
+}
+static void print_dec(uint32_t n) {
+    char str[11];
+    unsigned i = sizeof(str) - 1U;
+    str[i] = '\0';
+    do {
+        str[--i] = (char)('0' + (n % 10U));
+        n /= 10U;
+    } while (n != 0U);
+    print_str(&str[i]);
+}
+/* cycles of 'fn()' measured with the down-counting SysTick */
+static uint32_t cycles(void (*fn)(void)) {
+    SysTick->VAL = 0U;
+    uint32_t const t0 = SysTick->VAL;
+    (*fn)();
+    uint32_t const t1 = SysTick->VAL;
+    return (t0 - t1) & SysTick_LOAD_RELOAD_Msk;
+}
+static void nop(void) {
+}
+
+int main(void) {
+    SystemCoreClockUpdate();
+
+    /* USART2 on PA2/PA3 (same as bsp_nucleo-c031c6.c), polling */
+    RCC->APBENR1 |= (1U << 17U);
+    RCC->IOPENR  |= (1U << 0U);
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~((15U << 8U) | (15U << 12U)))
+                    | (1U << 8U) | (1U << 12U);
+    GPIOA->MODER  = (GPIOA->MODER & ~((3U << 4U) | (3U << 6U)))
+                    | (2U << 4U) | (2U << 6U);
+    USART2->BRR = (SystemCoreClock + 115200U/2U) / 115200U;
+    USART2->CR1 = USART_CR1_TE_Msk | USART_CR1_UE_Msk;
+
+    /* SysTick: CPU clock, free running, no interrupt */
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    RingBuf_ctor(&rb, buf, LEN);
+    uint32_t const overhead = cycles(&nop); /* call + SysTick reads */
+    print_str("operation,cycles_min,cycles_max\r\n");
+    for (unsigned op = 0U; op < sizeof(l_ops)/sizeof(l_ops[0]); ++op) {
+        uint32_t min = 0xFFFFFFFFU;
+        uint32_t max = 0U;
+        for (unsigned i = 0U; i < N_REPS; ++i) {
+            (*l_ops[op].setup)();
+            uint32_t const c = cycles(l_ops[op].op) - overhead;
+            min = (c < min) ? c : min;
+            max = (c > max) ? c : max;
+        }
+        print_str(l_ops[op].name);
+        print_str(",");
+        print_dec(min);
+        print_str(",");
+        print_dec(max);
+        print_str("\r\n");
+    }
+    for (;;) {
+    }
+}
+
+/* fault handler called from the exception handlers in the startup code */
+void assert_failed(char const * const module, int const loc);
+void assert_failed(char const * const module, int const loc) {
+    (void)module;
+    (void)loc;
+    for (;;) {
+    }
+}
+#endif /* ISR_COST_QEMU */
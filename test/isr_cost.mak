@@ -0,0 +1,155 @@
+##############################################################################
+# Product: Makefile for the ISR cost of RingBuf operations on Cortex-M0+
+#
+#                    Q u a n t u m  L e a P s
+#                    ------------------------
+#                    Modern Embedded Software
+#
+# Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+#
+# SPDX-License-Identifier: MIT
+##############################################################################
+#
+# Cross-compiles src/ring_buf.c with test/isr_cost.c for Cortex-M0+ in
+# every configuration of ISR_COST_CONFIGS and runs it under qemu-system-arm
+# with the TCG "insn" plugin, which counts the executed instructions.
+# The instructions per operation are written into
+# build_isr_cost/isr_cost.csv and compared with isr_cost_baseline.csv,
+# failing when any operation got more expensive, or when QEMU fails or
+# measures no instructions. Without the committed baseline, the default
+# target only reports the results ('check' fails without it).
+#
+# examples of invoking this Makefile:
+# make -f isr_cost.mak
+# make -f isr_cost.mak check        # requires isr_cost_baseline.csv
+# make -f isr_cost.mak baseline     # accept the current results
+# make -f isr_cost.mak GNU_ARM=/opt/gcc-arm QEMU_PLUGINS=/usr/lib/qemu
+#
+# The CPU cycles (rather than instructions) are measured on the
+# NUCLEO-C031C6 board itself by building isr_cost.c without ISR_COST_QEMU
+# (make -f isr_cost.mak nucleo), which prints the SysTick cycles over
+# USART2.
+#
+
+#-----------------------------------------------------------------------------
+# configurations: <name>:<compiler options> (':' separates, '+' is a space)
+ISR_COST_CONFIGS := \
+	O1-ctr2:-O1 \
+	O2-ctr2:-O2 \
+	Os-ctr2:-Os \
+	Os-ctr1:-Os+-DRING_BUF_CTR_SIZE=1U \
+	Os-ctr4:-Os+-DRING_BUF_CTR_SIZE=4U
+
+# operations in isr_cost.c (indexes into l_ops[])
+ISR_COST_OPS := 0 1 2 3 4 5 6 7 8
+
+# repetitions of every operation
+ISR_COST_REPS := 1000
+
+#-----------------------------------------------------------------------------
+# GNU-ARM toolset (NOTE: You need to adjust to your machine)
+#
+ifeq ($(GNU_ARM),)
+GNU_ARM := $(QTOOLS)/gnu_arm-none-eabi
+endif
+CC   := $(GNU_ARM)/bin/arm-none-eabi-gcc
+BIN  := $(GNU_ARM)/bin/arm-none-eabi-objcopy
+
+QEMU := qemu-system-arm
+ifeq ($(QEMU_PLUGINS),)
+QEMU_PLUGINS := /usr/lib/qemu
+endif
+QEMU_FLAGS := -M microbit -nographic -semihosting \
+	-plugin $(QEMU_PLUGINS)/libinsn.so -d plugin
+
+ARM_CPU := -mcpu=cortex-m0plus -mthumb
+CFLAGS  := -g $(ARM_CPU) -std=c11 -Wall -ffunction-sections -fdata-sections \
+	-I../src -ffreestanding
+
+BIN_DIR  := build_isr_cost
+RESULTS  := $(BIN_DIR)/isr_cost.csv
+BASELINE := isr_cost_baseline.csv
+
+# instruction count from the output of the insn plugin: the "total insns:"
+# line (QEMU 8.2+), the sum of the "cpu N insns:" lines, or the "insns:"
+# line (older QEMU)
+INSNS_AWK := '/^total insns:/ { t = $$NF } \
+	/^cpu [0-9]+ insns:/ { c += $$NF; n++ } \
+	/^insns:/ { i = $$NF } \
+	END { if (t != "") print t; else if (n) print c; else print i }'
+
+#-----------------------------------------------------------------------------
+# rules
+#
+.PHONY : all check baseline nucleo clean
+
+ifneq ($(wildcard $(BASELINE)),)
+all : check
+else
+all : $(RESULTS)
+	@echo "no $(BASELINE) yet: review the results above, then"
+	@echo "'make -f isr_cost.mak baseline' and commit $(BASELINE)"
+endif
+
+# build and run every configuration, instructions = insns(op) - insns(no op)
+$(RESULTS) : isr_cost.c ../src/ring_buf.c ../src/ring_buf.h isr_cost_qemu.ld
+	@mkdir -p $(BIN_DIR)
+	@echo "config,operation,instructions" > $@
+	@for cfg in $(ISR_COST_CONFIGS); do \
+	  name=$${cfg%%:*}; opts=`echo $${cfg#*:} | tr '+' ' '`; \
+	  elf=$(BIN_DIR)/isr_cost_$$name.elf; \
+	  $(CC) $(CFLAGS) $$opts -DISR_COST_QEMU -Tisr_cost_qemu.ld \
+	    -nostartfiles -specs=nosys.specs -Wl,--gc-sections \
+	    -o $$elf isr_cost.c ../src/ring_buf.c || exit 1; \
+	  for op in $(ISR_COST_OPS); do \
+	    base=`$(QEMU) $(QEMU_FLAGS) -kernel $$elf \
+	      -append "$$op $(ISR_COST_REPS) 0" 2>&1` \
+	      || { echo "$(QEMU) failed: $$base"; rm -f $@; exit 1; }; \
+	    meas=`$(QEMU) $(QEMU_FLAGS) -kernel $$elf \
+	      -append "$$op $(ISR_COST_REPS) 1" 2>&1` \
+	      || { echo "$(QEMU) failed: $$meas"; rm -f $@; exit 1; }; \
+	    base=`echo "$$base" | awk $(INSNS_AWK)`; \
+	    meas=`echo "$$meas" | awk $(INSNS_AWK)`; \
+	    for v in "$$base" "$$meas"; do case "$$v" in ''|*[!0-9]*) \
+	      echo "$$name op $$op: no instruction count in the output" \
+	           "of the $(QEMU) insn plugin ('$$v')"; \
+	      rm -f $@; exit 1;; esac; done; \
+	    insns=$$(( (meas - base) / $(ISR_COST_REPS) )); \
+	    if [ $$insns -le 0 ]; then \
+	      echo "$$name op $$op: no instructions measured"; \
+	      rm -f $@; exit 1; fi; \
+	    echo "$$name,$$op,$$insns" >> $@; \
+	  done; \
+	done
+	@cat $@
+
+# compare with the baseline: fail if any operation got more expensive
+check : $(RESULTS)
+	@if [ -f $(BASELINE) ]; then \
+	  awk -F, 'NR==FNR { base[$$1","$$2] = $$3; next } \
+	    FNR > 1 && (($$1","$$2) in base) && $$3 > base[$$1","$$2] { \
+	      printf("REGRESSION %s op %s: %d > %d instructions\n", \
+	             $$1, $$2, $$3, base[$$1","$$2]); bad = 1 } \
+	    END { exit bad }' $(BASELINE) $(RESULTS); \
+	else \
+	  echo "no $(BASELINE), see 'make -f isr_cost.mak baseline'"; \
+	  exit 1; \
+	fi
+
+baseline : $(RESULTS)
+	cp $(RESULTS) $(BASELINE)
+
+# CPU cycles on the NUCLEO-C031C6 board (SysTick), printed over USART2
+NUCLEO_DIR := ../3rd_party/nucleo-c031c6
+nucleo :
+	@mkdir -p $(BIN_DIR)
+	$(CC) $(CFLAGS) -Os -DSTM32C031xx -I$(NUCLEO_DIR) \
+	  -T$(NUCLEO_DIR)/nucleo-c031c6.ld -specs=nosys.specs -specs=nano.specs \
+	  -Wl,--gc-sections -o $(BIN_DIR)/isr_cost_nucleo.elf \
+	  isr_cost.c ../src/ring_buf.c \
+	  $(NUCLEO_DIR)/system_stm32c0xx.c $(NUCLEO_DIR)/gnu/startup_stm32c031xx.c
+	$(BIN) -O binary $(BIN_DIR)/isr_cost_nucleo.elf \
+	  $(BIN_DIR)/isr_cost_nucleo.bin
+
+clean :
+	rm -rf $(BIN_DIR)
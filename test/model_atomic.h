@@ -0,0 +1,45 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+/* Replacement of the C11 atomic loads and stores for the exhaustive
+* interleaving model of the ring buffer (see model_ring_buf.c). This header
+* must be included *before* the ring buffer implementation, so that all
+* atomic accesses in ring_buf.c become calls into the model.
+*/
+#ifndef MODEL_ATOMIC_H
+#define MODEL_ATOMIC_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+uint64_t model_load(void const volatile *obj, memory_order mo);
+void model_store(void volatile *obj, uint64_t val, memory_order mo);
+
+#undef atomic_load
+#define atomic_load(obj_) \
+    model_load((void const volatile *)(obj_), memory_order_seq_cst)
+
+#undef atomic_load_explicit
+#define atomic_load_explicit(obj_, mo_) \
+    model_load((void const volatile *)(obj_), (mo_))
+
+#undef atomic_store
+#define atomic_store(obj_, val_) \
+    model_store((void volatile *)(obj_), (val_), memory_order_seq_cst)
+
+#undef atomic_store_explicit
+#define atomic_store_explicit(obj_, val_, mo_) \
+    model_store((void volatile *)(obj_), (val_), (mo_))
+
+#endif /* MODEL_ATOMIC_H */
@@ -0,0 +1,457 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+/* Exhaustive interleaving model of the lock-free ring buffer (see
+* 'make model'), in the spirit of the Relacy and CDSChecker tools.
+*
+* The producer and consumer run as cooperative coroutines and every atomic
+* access in ring_buf.c becomes a scheduling point (see model_atomic.h).
+* The model explores *all* interleavings of the atomic accesses as well as
+* all values that each atomic load is allowed to read under the C11 memory
+* model (not just the latest one), re-executing the test from scratch for
+* every choice (stateless model checking).
+*
+* The happens-before relation is tracked with vector clocks, which are only
+* joined when an acquire load reads from a release store. A data race on
+* the (non-atomic) ring buffer storage is reported when the producer writes
+* a slot that the consumer has not "released" yet or when the consumer reads
+* a slot whose write has not been "published" to it.
+*
+* With RING_BUF_SNAPSHOT, an observer thread reads the consumer's position
+* with the seqlock of RingBuf_snapshot() (the tail and the sequence of its
+* wrap-arounds), which must be a position that the consumer has actually
+* passed, and it must not go back. (The copy of the elements is validated
+* with a fence against the non-atomic accesses, which the model cannot
+* express, so it is covered by 'make stress' instead.)
+*
+* To demonstrate that the model is sensitive enough to tune the memory
+* orders, every configuration is also executed with the acquire/release
+* orders in ring_buf.c weakened to relaxed ("mutations"), one at a time.
+* Each mutation must be detected by the model.
+*/
+#define _XOPEN_SOURCE 700 /* for ucontext */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <ucontext.h>
+
+#include "model_atomic.h" /* must precede the ring buffer implementation */
+#include "ring_buf.c"     /* the code under test with modeled atomics */
+
+enum { INIT_THR, PROD_THR, CONS_THR, OBS_THR, MAX_THR };
+
+#define MAX_LOCS    4U
+#define MAX_STORES  64U
+#define MAX_CHOICES 1024U
+#define STACK_SIZE  (64U * 1024U)
+#define OBS_LOADS   6U /* loads of the observer before it waits (spin) */
+
+typedef struct {
+    uint32_t c[MAX_THR];
+} VClock;
+
+typedef struct {
+    uint64_t val;
+    uint32_t epoch;  /* epoch of the storing thread */
+    uint8_t thr;     /* the storing thread */
+    bool rel;        /* release store? */
+    VClock clk;      /* clock of the storing thread (for release) */
+} Store;
+
+typedef struct {
+    void const volatile *addr;
+    Store st[MAX_STORES];  /* stores in the modification order */
+    uint32_t n_st;
+    uint32_t last[MAX_THR]; /* last store read/written by each thread */
+} Loc;
+
+typedef struct {
+    ucontext_t ctx;
+    VClock clk;
+    bool done;
+    void (*fun)(void);
+} Thread;
+
+/* the memory model... */
+static Loc      l_loc[MAX_LOCS];
+static uint32_t l_n_loc;
+static Thread   l_thr[MAX_THR];
+static uint8_t  l_cur; /* currently running thread */
+static ucontext_t l_sched_ctx;
+static char     l_stack[MAX_THR][STACK_SIZE];
+
+/* weakening of memory orders ("mutation") for one location */
+static void const volatile *l_weak_addr;
+static bool     l_weak_store; /* weaken stores (or loads) to relaxed */
+
+/* exploration of choices (depth-first search) */
+static uint32_t l_choice[MAX_CHOICES]; /* alternative taken */
+static uint32_t l_n_alt[MAX_CHOICES];  /* number of alternatives */
+static uint32_t l_depth;  /* current choice point in this execution */
+static uint32_t l_prefix; /* choice points to replay */
+
+/* test harness state... */
+typedef struct {
+    char const *name;
+    RingBufCtr len;  /* ring length */
+    uint32_t n_put;  /* number of put attempts */
+    uint32_t n_get;  /* number of get attempts */
+    bool process_all; /* consumer uses RingBuf_process_all()? */
+    uint32_t n_obs;  /* number of the observer's position reads */
+    uint32_t seq0;   /* initial wrap-around sequence */
+    uint32_t n_skip; /* elements passed through before the threads start */
+    uint32_t n_fill; /* elements put before the threads start */
+} Config;
+
+static Config const *l_cfg;
+static RingBuf l_rb;
+static RingBufElement l_sto[8];
+static uint32_t l_wr_epoch[8]; /* producer epoch of the last write to slot */
+static uint32_t l_rd_epoch[8]; /* consumer epoch of the last read of slot */
+static uint32_t l_puts;
+static uint32_t l_gets;
+static uint32_t l_obs_loads; /* loads by the observer in this execution */
+static char const *l_error;
+
+/*..........................................................................*/
+static uint32_t choose(uint32_t n_alt) {
+    if (n_alt <= 1U) {
+        return 0U; /* no choice */
+    }
+    if (l_depth >= MAX_CHOICES) {
+        l_error = "MAX_CHOICES exceeded";
+        return 0U;
+    }
+    if (l_depth >= l_prefix) { /* new choice point? */
+        l_choice[l_depth] = 0U;
+        l_n_alt[l_depth]  = n_alt;
+    }
+    return l_choice[l_depth++];
+}
+/*..........................................................................*/
+static bool next_execution(void) {
+    l_prefix = l_depth;
+    while ((l_prefix > 0U)
+           && (l_choice[l_prefix - 1U] + 1U >= l_n_alt[l_prefix - 1U]))
+    {
+        --l_prefix;
+    }
+    if (l_prefix == 0U) {
+        return false; /* all choices explored */
+    }
+    ++l_choice[l_prefix - 1U];
+    return true;
+}
+
+/*..........................................................................*/
+static Loc *find_loc(void const volatile *addr) {
+    for (uint32_t i = 0U; i < l_n_loc; ++i) {
+        if (l_loc[i].addr == addr) {
+            return &l_loc[i];
+        }
+    }
+    Loc *loc = &l_loc[l_n_loc++]; /* new location */
+    memset(loc, 0, sizeof(*loc));
+    loc->addr = addr;
+    return loc;
+}
+/*..........................................................................*/
+static void yield(void) { /* scheduling point before every atomic access */
+    if (l_cur != INIT_THR) {
+        swapcontext(&l_thr[l_cur].ctx, &l_sched_ctx);
+    }
+}
+/*..........................................................................*/
+uint64_t model_load(void const volatile *obj, memory_order mo) {
+    yield();
+    if (l_cur == OBS_THR) {
+        ++l_obs_loads;
+    }
+    Thread * const t = &l_thr[l_cur];
+    uint32_t const epoch = ++t->clk.c[l_cur];
+    (void)epoch;
+    Loc * const loc = find_loc(obj);
+    if ((obj == l_weak_addr) && !l_weak_store) {
+        mo = memory_order_relaxed;
+    }
+
+    /* the oldest store that can still be read (coherence) */
+    uint32_t lb = loc->last[l_cur];
+    for (uint32_t i = lb + 1U; i < loc->n_st; ++i) {
+        Store const * const s = &loc->st[i];
+        if (t->clk.c[s->thr] >= s->epoch) { /* store happens-before load? */
+            lb = i;
+        }
+    }
+    /* choose the store to read from, the latest first (the observer
+    * spinning in the seqlock eventually reads the latest store)
+    */
+    uint32_t const i = loc->n_st - 1U
+        - (((l_cur == OBS_THR) && (l_obs_loads > OBS_LOADS))
+           ? 0U : choose(loc->n_st - lb));
+    Store const * const s = &loc->st[i];
+    loc->last[l_cur] = i;
+    if ((mo != memory_order_relaxed) && s->rel) { /* synchronizes-with? */
+        for (uint32_t k = 0U; k < MAX_THR; ++k) {
+            if (t->clk.c[k] < s->clk.c[k]) {
+                t->clk.c[k] = s->clk.c[k];
+            }
+        }
+    }
+    return s->val;
+}
+/*..........................................................................*/
+void model_store(void volatile *obj, uint64_t val, memory_order mo) {
+    yield();
+    Thread * const t = &l_thr[l_cur];
+    uint32_t const epoch = ++t->clk.c[l_cur];
+    Loc * const loc = find_loc(obj);
+    if ((obj == l_weak_addr) && l_weak_store) {
+        mo = memory_order_relaxed;
+    }
+    if (loc->n_st >= MAX_STORES) {
+        l_error = "MAX_STORES exceeded";
+        return;
+    }
+    Store * const s = &loc->st[loc->n_st];
+    s->val   = val;
+    s->epoch = epoch;
+    s->thr   = l_cur;
+    s->rel   = (mo != memory_order_relaxed);
+    s->clk   = t->clk;
+    loc->last[l_cur] = loc->n_st;
+    ++loc->n_st;
+}
+
+/*..........................................................................*/
+static void producer(void) {
+    VClock const * const clk = &l_thr[PROD_THR].clk;
+    for (uint32_t k = 0U; k < l_cfg->n_put; ++k) {
+        if (RingBuf_put(&l_rb, (RingBufElement)(l_puts + 1U))) {
+            RingBufCtr const slot = (RingBufCtr)(l_puts % l_cfg->len);
+            if (clk->c[CONS_THR] < l_rd_epoch[slot]) {
+                l_error = "data race: put() overwrites unreleased slot";
+            }
+            /* the slot was written just before the head store */
+            l_wr_epoch[slot] = clk->c[PROD_THR] - 1U;
+            ++l_puts;
+        }
+    }
+}
+/*..........................................................................*/
+static void consume(RingBufElement const el) {
+    VClock const * const clk = &l_thr[CONS_THR].clk;
+    RingBufCtr const slot = (RingBufCtr)(l_gets % l_cfg->len);
+    if (clk->c[PROD_THR] < l_wr_epoch[slot]) {
+        l_error = "data race: get() reads unpublished slot";
+    }
+    if (el != (RingBufElement)(l_gets + 1U)) {
+        l_error = "FIFO order violated";
+    }
+    l_rd_epoch[slot] = clk->c[CONS_THR];
+    ++l_gets;
+}
+/*..........................................................................*/
+static void consumer(void) {
+    for (uint32_t k = 0U; k < l_cfg->n_get; ++k) {
+        if (l_cfg->process_all) {
+            RingBuf_process_all(&l_rb, &consume);
+        }
+        else {
+            RingBufElement el;
+            if (RingBuf_get(&l_rb, &el)) {
+                consume(el);
+            }
+        }
+    }
+}
+/*..........................................................................*/
+static void observer(void) {
+#ifdef RING_BUF_SNAPSHOT
+    uint32_t last = 0U;
+    for (uint32_t k = 0U; k < l_cfg->n_obs; ++k) {
+        RingBufCtr tail;
+        uint32_t const seq = consumer_seq(&l_rb, &tail);
+        uint32_t const pos = ((seq - l_cfg->seq0) >> 1) * l_cfg->len + tail;
+        if (pos > l_gets) {
+            l_error = "snapshot: position ahead of the consumer";
+        }
+        if (pos < last) {
+            l_error = "snapshot: position went back";
+        }
+        last = pos;
+    }
+#endif
+}
+/*..........................................................................*/
+static void thread_entry(void) {
+    (*l_thr[l_cur].fun)();
+    l_thr[l_cur].done = true;
+    /* returns to l_sched_ctx via uc_link */
+}
+
+/*..........................................................................*/
+static void execute(void) {
+    memset(l_thr, 0, sizeof(l_thr));
+    memset(l_wr_epoch, 0, sizeof(l_wr_epoch));
+    memset(l_rd_epoch, 0, sizeof(l_rd_epoch));
+    l_n_loc = 0U;
+    l_puts  = 0U;
+    l_gets  = 0U;
+    l_obs_loads = 0U;
+    l_depth = 0U;
+
+    /* the initialization happens-before all threads */
+    l_cur = INIT_THR;
+    RingBuf_ctor(&l_rb, l_sto, l_cfg->len);
+#ifdef RING_BUF_SNAPSHOT
+    atomic_store(&l_rb.seq, l_cfg->seq0);
+#endif
+    for (uint32_t k = 0U; k < l_cfg->n_skip; ++k) { /* start at an offset */
+        RingBufElement el;
+        (void)RingBuf_put(&l_rb, (RingBufElement)(k + 1U));
+        (void)RingBuf_get(&l_rb, &el);
+    }
+    l_puts = l_cfg->n_skip;
+    l_gets = l_cfg->n_skip;
+    for (uint32_t k = 0U; k < l_cfg->n_fill; ++k) {
+        (void)RingBuf_put(&l_rb, (RingBufElement)(l_puts + 1U));
+        ++l_puts;
+    }
+    l_thr[PROD_THR].fun = &producer;
+    l_thr[CONS_THR].fun = &consumer;
+    l_thr[OBS_THR].fun  = &observer;
+    l_thr[PROD_THR].done = (l_cfg->n_put == 0U); /* filled at INIT? */
+    l_thr[OBS_THR].done  = (l_cfg->n_obs == 0U); /* no observer? */
+    for (uint8_t k = PROD_THR; k < MAX_THR; ++k) {
+        l_thr[k].clk = l_thr[INIT_THR].clk;
+        getcontext(&l_thr[k].ctx);
+        l_thr[k].ctx.uc_stack.ss_sp   = l_stack[k];
+        l_thr[k].ctx.uc_stack.ss_size = STACK_SIZE;
+        l_thr[k].ctx.uc_link = &l_sched_ctx;
+        makecontext(&l_thr[k].ctx, &thread_entry, 0);
+    }
+
+    /* run the threads, choosing the next one at every scheduling point */
+    for (;;) {
+        /* the observer spinning in the seqlock waits for the others */
+        bool const obs_wait = (l_obs_loads >= OBS_LOADS)
+            && !(l_thr[PROD_THR].done && l_thr[CONS_THR].done);
+        uint8_t runnable[MAX_THR];
+        uint32_t n = 0U;
+        if ((l_cur != INIT_THR) && !l_thr[l_cur].done
+            && !((l_cur == OBS_THR) && obs_wait))
+        {
+            runnable[n++] = l_cur; /* prefer the current thread first */
+        }
+        for (uint8_t k = PROD_THR; k < MAX_THR; ++k) {
+            if (!l_thr[k].done && (k != l_cur)
+                && !((k == OBS_THR) && obs_wait))
+            {
+                runnable[n++] = k;
+            }
+        }
+        if (n == 0U) {
+            break;
+        }
+        l_cur = runnable[choose(n)];
+        swapcontext(&l_sched_ctx, &l_thr[l_cur].ctx);
+    }
+
+    if (l_gets > l_puts) {
+        l_error = "more elements received than sent";
+    }
+}
+/*..........................................................................*/
+/* explore all executions, return the number of executions or 0 on error */
+static uint32_t explore(void) {
+    uint32_t n_exec = 0U;
+    l_prefix = 0U;
+    l_error  = (char const *)0;
+    do {
+        execute();
+        ++n_exec;
+    } while ((l_error == (char const *)0) && next_execution());
+    return (l_error == (char const *)0) ? n_exec : 0U;
+}
+
+/*..........................................................................*/
+int main(void) {
+    static Config const cfgs[] = {
+        { "len 2, 2 puts, 2 gets",        2U, 2U, 2U, false, 0U, 0U, 0U, 0U },
+        { "len 2, 3 puts, 2 gets",        2U, 3U, 2U, false, 0U, 0U, 0U, 0U },
+        { "len 3, 3 puts, 2 gets",        3U, 3U, 2U, false, 0U, 0U, 0U, 0U },
+        { "len 2, 3 puts, 2 process_all", 2U, 3U, 2U, true,  0U, 0U, 0U, 0U },
+#ifdef RING_BUF_SNAPSHOT
+        /* the observer and the consumer of the filled ring buffer, where
+        * both the tail and seq wrap around (seq from 0xFFFFFFFE to 0)
+        */
+        { "len 2, filled, 1 get, observer", 2U, 0U, 1U, false,
+          2U, 0xFFFFFFFEU, 1U, 1U },
+        { "len 3, filled, 2 gets, observer", 3U, 0U, 2U, false,
+          1U, 0xFFFFFFFEU, 2U, 2U },
+#endif
+    };
+    static struct {
+        char const *name;
+        void const volatile *addr;
+        bool store;
+    } const mutations[] = {
+        { "head store relaxed", &l_rb.head, true  },
+        { "head load relaxed",  &l_rb.head, false },
+        { "tail store relaxed", &l_rb.tail, true  },
+        { "tail load relaxed",  &l_rb.tail, false },
+#ifdef RING_BUF_SNAPSHOT
+        { "seq store relaxed",  &l_rb.seq,  true  },
+        { "seq load relaxed",   &l_rb.seq,  false },
+#endif
+    };
+    uint32_t const n_cfgs = sizeof(cfgs)/sizeof(cfgs[0]);
+    bool ok = true;
+
+    /* the original memory orders must pass all configurations... */
+    l_weak_addr = (void const volatile *)0;
+    for (uint32_t i = 0U; i < n_cfgs; ++i) {
+        l_cfg = &cfgs[i];
+        uint32_t n = explore();
+        printf("%-30s %8u executions %s\n", l_cfg->name, n,
+               (n != 0U) ? "OK" : l_error);
+        ok = ok && (n != 0U);
+    }
+
+    /* ...and each mutation must fail in at least one configuration */
+    for (uint32_t j = 0U; j < sizeof(mutations)/sizeof(mutations[0]); ++j) {
+        l_weak_addr  = mutations[j].addr;
+        l_weak_store = mutations[j].store;
+        uint32_t i = 0U;
+        for (; i < n_cfgs; ++i) {
+            l_cfg = &cfgs[i];
+            if (explore() == 0U) {
+                break; /* detected */
+            }
+        }
+        if (i < n_cfgs) {
+            printf("mutation: %-20s detected (%s): %s\n",
+                   mutations[j].name, cfgs[i].name, l_error);
+        }
+        else {
+            printf("mutation: %-20s NOT DETECTED\n", mutations[j].name);
+            ok = false;
+        }
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : -1;
+}
@@ -74,6 +74,7 @@ ASM_SRCS :=
 C_SRCS := \
 	ring_buf.c \
 	test_ring_buf.c \
+	uart_drv.c \
 	et.c \
 	bsp_nucleo-c031c6.c \
 	system_stm32c0xx.c \
@@ -0,0 +1,219 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+/* Multi-threaded stress test of the lock-free ring buffer, intended to run
+* under ThreadSanitizer (see 'make stress'). Each producer/consumer pair
+* has its own ring buffer (single-producer, single-consumer), but all pairs
+* run concurrently with randomized burst sizes and ring lengths, so that
+* the full/empty/wrap-around paths are hit at random moments. With
+* RING_BUF_SNAPSHOT, each pair also has an observer thread that takes
+* RingBuf_snapshot() copies while the elements are streamed.
+*/
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <sched.h>
+#include <pthread.h>
+
+#include "ring_buf.h"
+
+/* usage: stress_ring_buf [number-of-pairs [elements-per-pair [seed]]] */
+
+#define MAX_PAIRS 16U
+#define MAX_LEN   17U
+#define MAX_BURST 64U
+
+typedef struct {
+    RingBuf rb;
+    RingBufElement sto[MAX_LEN];
+    uint32_t seed;
+    uint32_t n_elem;
+    uint32_t n_full;  /* statistics: times the producer found ring full */
+    uint32_t n_empty; /* statistics: times the consumer found ring empty */
+    bool ok;
+#ifdef RING_BUF_SNAPSHOT
+    atomic_bool cons_done; /* set when the consumer is done */
+    uint32_t n_snap;  /* statistics: elements copied by the observer */
+    bool snap_ok;     /* every snapshot is a consecutive sequence */
+#endif
+} Pair;
+
+static Pair l_pairs[MAX_PAIRS];
+
+/* the next element expected by the consumer in RingBuf_process_all() */
+static _Thread_local RingBufElement l_expected;
+static _Thread_local bool l_ok;
+
+/*..........................................................................*/
+static uint32_t rand_next(uint32_t *seed) { /* xorshift32 */
+    uint32_t x = *seed;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *seed = x;
+    return x;
+}
+/*..........................................................................*/
+static void *producer(void *arg) {
+    Pair * const p = (Pair *)arg;
+    uint32_t seed = p->seed;
+    uint32_t i = 0U;
+    while (i < p->n_elem) {
+        uint32_t burst = 1U + (rand_next(&seed) % MAX_BURST);
+        for (; (burst != 0U) && (i < p->n_elem); --burst) {
+            if (RingBuf_num_free(&p->rb) > p->rb.end - 1U) {
+                p->ok = false; /* inconsistent free count */
+            }
+            if (RingBuf_put(&p->rb, (RingBufElement)i)) {
+                ++i;
+            }
+            else {
+                ++p->n_full;
+                sched_yield();
+            }
+        }
+        if ((rand_next(&seed) & 3U) == 0U) {
+            sched_yield(); /* let the consumer catch up (or not) */
+        }
+    }
+    return (void *)0;
+}
+/*..........................................................................*/
+static void handler(RingBufElement const el) {
+    if (el != l_expected) {
+        l_ok = false;
+    }
+    ++l_expected;
+}
+/*..........................................................................*/
+static void *consumer(void *arg) {
+    Pair * const p = (Pair *)arg;
+    uint32_t seed = ~p->seed;
+    uint32_t i = 0U;
+    l_ok = true;
+    while (i < p->n_elem) {
+        if ((rand_next(&seed) & 1U) != 0U) { /* burst of RingBuf_get() */
+            uint32_t burst = 1U + (rand_next(&seed) % MAX_BURST);
+            for (; (burst != 0U) && (i < p->n_elem); --burst) {
+                RingBufElement el;
+                if (RingBuf_get(&p->rb, &el)) {
+                    if (el != (RingBufElement)i) {
+                        l_ok = false;
+                    }
+                    ++i;
+                }
+                else {
+                    ++p->n_empty;
+                    sched_yield();
+                }
+            }
+        }
+        else { /* drain all with RingBuf_process_all() */
+            RingBufCtr n_used =
+                (RingBufCtr)(p->rb.end - 1U - RingBuf_num_free(&p->rb));
+            l_expected = (RingBufElement)i;
+            RingBuf_process_all(&p->rb, &handler);
+            /* at least the elements seen before must have been processed */
+            uint32_t n = (RingBufElement)(l_expected - (RingBufElement)i);
+            if (n < n_used) {
+                l_ok = false;
+            }
+            i += n;
+        }
+    }
+    if (!l_ok) {
+        p->ok = false;
+    }
+#ifdef RING_BUF_SNAPSHOT
+    atomic_store(&p->cons_done, true);
+#endif
+    return (void *)0;
+}
+#ifdef RING_BUF_SNAPSHOT
+/*..........................................................................*/
+static void *observer(void *arg) {
+    Pair * const p = (Pair *)arg;
+    while (!atomic_load(&p->cons_done)) {
+        RingBufElement snap[MAX_LEN];
+        RingBufCtr const k = RingBuf_snapshot(&p->rb, snap, MAX_LEN);
+        for (RingBufCtr i = 1U; i < k; ++i) {
+            if (snap[i] != (RingBufElement)(snap[i - 1U] + 1U)) {
+                p->snap_ok = false;
+            }
+        }
+        p->n_snap += k;
+        sched_yield();
+    }
+    return (void *)0;
+}
+#endif
+
+/*..........................................................................*/
+int main(int argc, char *argv[]) {
+    uint32_t n_pairs = (argc > 1) ? (uint32_t)strtoul(argv[1], 0, 0) : 4U;
+    uint32_t n_elem  = (argc > 2) ? (uint32_t)strtoul(argv[2], 0, 0) : 100000U;
+    uint32_t seed    = (argc > 3) ? (uint32_t)strtoul(argv[3], 0, 0) : 12345U;
+    if ((n_pairs == 0U) || (n_pairs > MAX_PAIRS) || (seed == 0U)) {
+        fprintf(stderr, "1..%u pairs and non-zero seed required\n",
+                MAX_PAIRS);
+        return -1;
+    }
+    printf("stress: %u pairs, %u elements each, seed %u\n",
+           n_pairs, n_elem, seed);
+
+    pthread_t thr[3U * MAX_PAIRS];
+    for (uint32_t k = 0U; k < n_pairs; ++k) {
+        Pair * const p = &l_pairs[k];
+        p->seed   = rand_next(&seed);
+        p->n_elem = n_elem;
+        p->ok     = true;
+        RingBuf_ctor(&p->rb, p->sto, 2U + (p->seed % (MAX_LEN - 1U)));
+        pthread_create(&thr[3U*k], (pthread_attr_t *)0, &consumer, p);
+        pthread_create(&thr[3U*k + 1U], (pthread_attr_t *)0, &producer, p);
+#ifdef RING_BUF_SNAPSHOT
+        p->snap_ok = true;
+        atomic_store(&p->cons_done, false);
+        pthread_create(&thr[3U*k + 2U], (pthread_attr_t *)0, &observer, p);
+#endif
+    }
+
+    bool ok = true;
+    for (uint32_t k = 0U; k < n_pairs; ++k) {
+        Pair * const p = &l_pairs[k];
+        pthread_join(thr[3U*k], (void **)0);
+        pthread_join(thr[3U*k + 1U], (void **)0);
+#ifdef RING_BUF_SNAPSHOT
+        pthread_join(thr[3U*k + 2U], (void **)0);
+        /* the tail wrapped around once per every 'end' elements */
+        uint32_t const seq = atomic_load(&p->rb.seq);
+        if ((seq != 2U * (n_elem / (uint32_t)p->rb.end)) || !p->snap_ok) {
+            p->ok = false;
+        }
+        printf("pair %2u: len %2u, full %8u, empty %8u, snap %8u %s\n",
+               k, (unsigned)p->rb.end, p->n_full, p->n_empty, p->n_snap,
+               p->ok ? "OK" : "FAILED");
+#else
+        printf("pair %2u: len %2u, full %8u, empty %8u %s\n",
+               k, (unsigned)p->rb.end, p->n_full, p->n_empty,
+               p->ok ? "OK" : "FAILED");
+#endif
+        ok = ok && p->ok;
+    }
+    printf("%s\n", ok ? "OK" : "FAILED");
+    return ok ? 0 : -1;
+}
@@ -32,6 +32,31 @@ static RingBufElement test_data[] = {
 };
 static RingBufCtr test_idx;
 
+/* statically allocated ring buffer with the compile-time length */
+RING_BUF_DEFINE(fixed_rb, 8U);
+
+#ifdef Q_HOST
+/* large ring buffer (too big for the embedded targets) */
+#if (RING_BUF_CTR_SIZE <= 2U)
+#define BIG_LEN ((RingBufCtr)~(RingBufCtr)0) /* max. length for RingBufCtr */
+#else
+#define BIG_LEN (0x10000U + 7U) /* beyond the range of uint16_t counter */
+#endif
+static RingBufElement big_buf[BIG_LEN];
+static RingBuf big_rb;
+
+/* performance test workers */
+static unsigned long put_get_worker(void *arg, unsigned long n_ops);
+static unsigned long fixed_put_get_worker(void *arg, unsigned long n_ops);
+static unsigned long producer_worker(void *arg, unsigned long n_ops);
+static unsigned long consumer_worker(void *arg, unsigned long n_ops);
+static atomic_bool cons_done; /* set when consumer_worker() finishes */
+#ifdef RING_BUF_SNAPSHOT
+static unsigned long observer_worker(void *arg, unsigned long n_ops);
+static unsigned long n_snap_els; /* elements copied by observer_worker() */
+#endif
+#endif /* Q_HOST */
+
 void setup(void) {
     /* executed before *every* non-skipped test */
 }
@@ -76,6 +101,203 @@ TEST("RingBuf_process_all test_data") {
     VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(buf) - 1U);
 }
 
+TEST("RingBuf_put_n/get_n wrap-around") {
+    static RingBufElement const in[] = {
+        0x10U, 0x11U, 0x12U, 0x13U, 0x14U, 0x15U, 0x16U, 0x17U, 0x18U
+    };
+    RingBufElement out[ARRAY_NELEM(in)];
+    RingBuf_ctor(&rb, buf, ARRAY_NELEM(buf));
+    VERIFY(5U == RingBuf_put_n(&rb, in, 5U));
+    VERIFY(3U == RingBuf_get_n(&rb, out, 3U));
+    VERIFY((0x10U == out[0]) && (0x12U == out[2]));
+
+    /* only the 5 free slots are filled, across the end of the buffer */
+    VERIFY(ARRAY_NELEM(buf) - 1U - 2U
+           == RingBuf_put_n(&rb, &in[0], ARRAY_NELEM(in)));
+    VERIFY(0U == RingBuf_num_free(&rb));
+    VERIFY(0U == RingBuf_put_n(&rb, in, 1U)); /* full */
+
+    VERIFY(ARRAY_NELEM(buf) - 1U == RingBuf_get_n(&rb, out, ARRAY_NELEM(out)));
+    VERIFY((0x13U == out[0]) && (0x14U == out[1]));
+    for (RingBufCtr i = 0U; i < ARRAY_NELEM(buf) - 1U - 2U; ++i) {
+        VERIFY(in[i] == out[2U + i]);
+    }
+    VERIFY(0U == RingBuf_get_n(&rb, out, 1U)); /* empty */
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(buf) - 1U);
+}
+
+TEST("RingBuf_peek_n leaves the elements in the buffer") {
+    RingBufElement out[8];
+    RingBuf_ctor(&rb, buf, ARRAY_NELEM(buf));
+    VERIFY(0U == RingBuf_peek_n(&rb, out, 4U)); /* empty */
+    for (RingBufElement i = 0U; i < 5U; ++i) { /* move tail near the end */
+        VERIFY(true == RingBuf_put(&rb, 0xFFU));
+        VERIFY(true == RingBuf_get(&rb, &out[0]));
+    }
+    for (RingBufElement i = 0U; i < 6U; ++i) { /* wraps around */
+        VERIFY(true == RingBuf_put(&rb, (RingBufElement)(0xA0U + i)));
+    }
+    VERIFY(4U == RingBuf_peek_n(&rb, out, 4U));
+    VERIFY(6U == RingBuf_peek_n(&rb, out, ARRAY_NELEM(out)));
+    for (RingBufElement i = 0U; i < 6U; ++i) {
+        VERIFY((RingBufElement)(0xA0U + i) == out[i]);
+    }
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(buf) - 1U - 6U);
+    VERIFY(6U == RingBuf_get_n(&rb, out, ARRAY_NELEM(out)));
+    VERIFY((RingBufElement)0xA0U == out[0]);
+}
+
+TEST("RingBufIter walks the elements from the oldest") {
+    RingBufIter it;
+    RingBufElement el;
+    RingBuf_ctor(&rb, buf, ARRAY_NELEM(buf));
+    RingBufIter_ctor(&it, &rb);
+    VERIFY(false == RingBufIter_next(&it, &el)); /* empty */
+    for (RingBufElement i = 0U; i < 6U; ++i) { /* move tail near the end */
+        VERIFY(true == RingBuf_put(&rb, 0xFFU));
+        VERIFY(true == RingBuf_get(&rb, &el));
+    }
+    for (RingBufElement i = 0U; i < 5U; ++i) { /* wraps around */
+        VERIFY(true == RingBuf_put(&rb, (RingBufElement)(0xB0U + i)));
+    }
+    RingBufIter_ctor(&it, &rb);
+    VERIFY(true == RingBuf_put(&rb, 0xEEU)); /* not in the iterated range */
+    for (RingBufElement i = 0U; i < 5U; ++i) {
+        VERIFY(true == RingBufIter_next(&it, &el));
+        VERIFY((RingBufElement)(0xB0U + i) == el);
+    }
+    VERIFY(false == RingBufIter_next(&it, &el));
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(buf) - 1U - 6U);
+}
+
+#ifdef RING_BUF_SNAPSHOT
+TEST("RingBuf_snapshot copies the oldest elements") {
+    RingBufElement out[8];
+    RingBufElement el;
+    RingBuf_ctor(&rb, buf, ARRAY_NELEM(buf));
+    atomic_store(&rb.seq, 0xFFFFFFFEU); /* seq wraps around in the laps */
+    VERIFY(0U == RingBuf_snapshot(&rb, out, ARRAY_NELEM(out))); /* empty */
+    for (unsigned n = 0U; n < 3U; ++n) { /* several laps of the tail */
+        for (RingBufElement i = 0U; i < 5U; ++i) {
+            VERIFY(true == RingBuf_put(&rb, (RingBufElement)(0xC0U + i)));
+        }
+        VERIFY(true == RingBuf_get(&rb, &el));
+        VERIFY(3U == RingBuf_snapshot(&rb, out, 3U));
+        VERIFY(4U == RingBuf_snapshot(&rb, out, ARRAY_NELEM(out)));
+        for (RingBufElement i = 0U; i < 4U; ++i) {
+            VERIFY((RingBufElement)(0xC1U + i) == out[i]);
+        }
+        VERIFY(4U == RingBuf_get_n(&rb, out, ARRAY_NELEM(out)));
+    }
+    VERIFY(0U == RingBuf_snapshot(&rb, out, ARRAY_NELEM(out)));
+}
+#endif /* RING_BUF_SNAPSHOT */
+
+TEST("RING_BUF_DEFINE initialized at compile time") {
+    VERIFY(fixed_rb_num_free() == ARRAY_NELEM(fixed_rb_sto) - 1U);
+    VERIFY(RingBuf_num_free(&fixed_rb) == ARRAY_NELEM(fixed_rb_sto) - 1U);
+}
+
+TEST("RING_BUF_DEFINE put/get wrap-around") {
+    RingBufElement el;
+    for (unsigned n = 0U; n < 3U; ++n) { /* several laps */
+        for (RingBufElement i = 0U; i < 7U; ++i) {
+            VERIFY(true == fixed_rb_put(0xA0U + i));
+        }
+        VERIFY(false == fixed_rb_put(0xFFU)); /* full */
+        VERIFY(0U == fixed_rb_num_free());
+        for (RingBufElement i = 0U; i < 5U; ++i) {
+            VERIFY(true == fixed_rb_get(&el));
+            VERIFY((RingBufElement)(0xA0U + i) == el);
+        }
+        /* the generic functions work on the same ring buffer */
+        for (RingBufElement i = 5U; i < 7U; ++i) {
+            VERIFY(true == RingBuf_get(&fixed_rb, &el));
+            VERIFY((RingBufElement)(0xA0U + i) == el);
+        }
+        VERIFY(false == fixed_rb_get(&el)); /* empty */
+    }
+}
+
+#ifdef Q_HOST
+TEST("RingBuf large fill and drain") {
+    RingBuf_ctor(&big_rb, big_buf, BIG_LEN);
+    VERIFY(RingBuf_num_free(&big_rb) == BIG_LEN - 1U);
+    for (RingBufCtr i = 0U; i < BIG_LEN - 1U; ++i) {
+        VERIFY(true == RingBuf_put(&big_rb, (RingBufElement)i));
+    }
+    VERIFY(RingBuf_num_free(&big_rb) == 0U);
+    VERIFY(false == RingBuf_put(&big_rb, 0U)); /* full */
+
+    RingBufElement el;
+    for (RingBufCtr i = 0U; i < BIG_LEN - 1U; ++i) {
+        VERIFY(true == RingBuf_get(&big_rb, &el));
+        VERIFY((RingBufElement)i == el);
+    }
+    VERIFY(false == RingBuf_get(&big_rb, &el)); /* empty */
+    VERIFY(RingBuf_num_free(&big_rb) == BIG_LEN - 1U);
+}
+
+TEST("RingBuf large wrap-around") {
+    RingBufElement el;
+    RingBuf_ctor(&big_rb, big_buf, BIG_LEN);
+    for (RingBufCtr i = 0U; i < BIG_LEN - 1U; ++i) { /* head/tail to end */
+        VERIFY(true == RingBuf_put(&big_rb, 0xFFU));
+        VERIFY(true == RingBuf_get(&big_rb, &el));
+    }
+    for (RingBufCtr i = 0U; i < 3U; ++i) {
+        VERIFY(true == RingBuf_put(&big_rb, (RingBufElement)(0xA0U + i)));
+    }
+    VERIFY(RingBuf_num_free(&big_rb) == BIG_LEN - 1U - 3U);
+    for (RingBufCtr i = 0U; i < 3U; ++i) {
+        VERIFY(true == RingBuf_get(&big_rb, &el));
+        VERIFY((RingBufElement)(0xA0U + i) == el);
+    }
+    VERIFY(RingBuf_num_free(&big_rb) == BIG_LEN - 1U);
+}
+
+#ifdef RING_BUF_SNAPSHOT
+PERF_TEST("perf: RingBuf_snapshot observer of 2 threads", 1000000U, 0U) {
+    RingBuf_ctor(&big_rb, big_buf, BIG_LEN);
+    atomic_store(&cons_done, false);
+    ET_perf_worker(&producer_worker, &big_rb, 0);
+    ET_perf_worker(&consumer_worker, &big_rb, 1);
+    ET_perf_worker(&observer_worker, &big_rb, 2);
+    ET_perf_run();
+    ET_perf_counter_("snapshot-el", (100U * n_snap_els) / 1000000U);
+    VERIFY(n_snap_els > 0U);
+    VERIFY(RingBuf_num_free(&big_rb) == BIG_LEN - 1U);
+}
+#endif /* RING_BUF_SNAPSHOT */
+
+PERF_TEST("perf: RingBuf_put/get 1 thread", 10000000U, 0U) {
+    RingBuf_ctor(&rb, buf, ARRAY_NELEM(buf));
+    ET_perf_worker(&put_get_worker, &rb, 0);
+    ET_perf_run();
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(buf) - 1U);
+}
+
+PERF_TEST("perf: RING_BUF_DEFINE put/get 1 thread", 10000000U, 0U) {
+    ET_perf_worker(&fixed_put_get_worker, (void *)0, 0);
+    ET_perf_run();
+    VERIFY(fixed_rb_num_free() == ARRAY_NELEM(fixed_rb_sto) - 1U);
+}
+
+PERF_TEST("perf: RingBuf_put/get 1 thread, 100 ms", 0U, 100U) {
+    ET_perf_worker(&put_get_worker, &rb, 0);
+    ET_perf_run();
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(buf) - 1U);
+}
+
+PERF_TEST("perf: RingBuf producer/consumer 2 threads", 1000000U, 0U) {
+    RingBuf_ctor(&big_rb, big_buf, BIG_LEN);
+    ET_perf_worker(&producer_worker, &big_rb, 0);
+    ET_perf_worker(&consumer_worker, &big_rb, 1);
+    ET_perf_run();
+    VERIFY(RingBuf_num_free(&big_rb) == BIG_LEN - 1U);
+}
+#endif /* Q_HOST */
+
 } /* TEST_GROUP() */
 
 static void rb_handler(RingBufElement const el) {
@@ -83,3 +305,66 @@ static void rb_handler(RingBufElement const el) {
     ++test_idx;
 }
 
+
+#ifdef Q_HOST
+static unsigned long put_get_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    unsigned long n;
+    for (n = 0U; (n < n_ops) && !ET_perf_stop(); n += 2U) {
+        RingBufElement el;
+        RingBuf_put(me, (RingBufElement)n);
+        RingBuf_get(me, &el);
+    }
+    return n;
+}
+
+static unsigned long fixed_put_get_worker(void *arg, unsigned long n_ops) {
+    (void)arg;
+    unsigned long n;
+    for (n = 0U; (n < n_ops) && !ET_perf_stop(); n += 2U) {
+        RingBufElement el;
+        fixed_rb_put((RingBufElement)n);
+        fixed_rb_get(&el);
+    }
+    return n;
+}
+
+static unsigned long producer_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        while (!RingBuf_put(me, (RingBufElement)n)) {
+        }
+    }
+    return n_ops;
+}
+
+static unsigned long consumer_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        RingBufElement el;
+        while (!RingBuf_get(me, &el)) {
+        }
+        VERIFY((RingBufElement)n == el);
+    }
+    atomic_store(&cons_done, true);
+    return 0U; /* the transfers are counted by the producer */
+}
+
+#ifdef RING_BUF_SNAPSHOT
+static unsigned long observer_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    static RingBufElement snap[128];
+    (void)n_ops;
+    n_snap_els = 0U;
+    /* snapshots of the elements streamed until the consumer is done */
+    while (!atomic_load(&cons_done)) {
+        RingBufCtr const k = RingBuf_snapshot(me, snap, ARRAY_NELEM(snap));
+        for (RingBufCtr i = 1U; i < k; ++i) { /* consecutive sequence */
+            VERIFY((RingBufElement)(snap[i - 1U] + 1U) == snap[i]);
+        }
+        n_snap_els += k;
+    }
+    return 0U; /* the operations are counted by the producer and consumer */
+}
+#endif /* RING_BUF_SNAPSHOT */
+#endif /* Q_HOST */
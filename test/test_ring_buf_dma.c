@@ -0,0 +1,180 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_buf_dma.h"
+#include "et.h" /* ET: embedded test */
+
+static RingBufElement buf[8];
+static RingBufDma rbd;
+
+/* simulated DMA "remaining count" register (counts down from len to 1) */
+static RingBufDmaNdtr sim_ndtr;
+
+/* simulated DMA transfer of 'n' elements starting with 'el' */
+static void sim_dma(RingBufDma * const dma, uint32_t n, RingBufElement el);
+
+#ifdef Q_HOST
+static RingBufElement big_buf[4096];
+static RingBufDma big_rbd;
+static unsigned long n_errors;
+
+/* performance test workers */
+static unsigned long dma_engine_worker(void *arg, unsigned long n_ops);
+static unsigned long dma_consumer_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("ring buffer filled by DMA") {
+
+sim_ndtr = ARRAY_NELEM(buf);
+RingBufDma_ctor(&rbd, buf, ARRAY_NELEM(buf), &sim_ndtr);
+
+TEST("RingBufDma_sync nothing received") {
+    RingBufElement el;
+    VERIFY(0U == RingBufDma_sync(&rbd));
+    VERIFY(false == RingBuf_get(&rbd.rb, &el));
+    VERIFY(RingBuf_num_free(&rbd.rb) == ARRAY_NELEM(buf) - 1U);
+}
+
+TEST("RingBufDma_sync head from remaining count") {
+    RingBufElement el;
+    sim_dma(&rbd, 3U, 0xA0U);
+    VERIFY(false == RingBuf_get(&rbd.rb, &el)); /* not synced yet */
+    VERIFY(3U == RingBufDma_sync(&rbd));
+    VERIFY(RingBuf_num_free(&rbd.rb) == ARRAY_NELEM(buf) - 1U - 3U);
+    for (RingBufElement i = 0U; i < 3U; ++i) {
+        VERIFY(true == RingBuf_get(&rbd.rb, &el));
+        VERIFY((RingBufElement)(0xA0U + i) == el);
+    }
+    VERIFY(false == RingBuf_get(&rbd.rb, &el));
+}
+
+TEST("RingBufDma_sync wrap-around (DMA reload)") {
+    RingBufElement el;
+    sim_dma(&rbd, 5U, 0xB0U); /* 3 + 5 == length: CNDTR reloaded */
+    VERIFY(ARRAY_NELEM(buf) == sim_ndtr);
+    VERIFY(5U == RingBufDma_sync(&rbd));
+    sim_dma(&rbd, 2U, 0xB5U);
+    VERIFY(2U == RingBufDma_sync(&rbd));
+    for (RingBufElement i = 0U; i < 7U; ++i) {
+        VERIFY(true == RingBuf_get(&rbd.rb, &el));
+        VERIFY((RingBufElement)(0xB0U + i) == el);
+    }
+    VERIFY(false == RingBuf_get(&rbd.rb, &el));
+    VERIFY(0U == rbd.overruns);
+}
+
+TEST("RingBufDma_sync overrun and flush") {
+    RingBufElement el;
+    sim_dma(&rbd, ARRAY_NELEM(buf) - 1U, 0xC0U); /* fills the ring */
+    RingBufDma_sync(&rbd);
+    VERIFY(0U == rbd.overruns);
+    sim_dma(&rbd, 1U, 0xCFU); /* overwrites the oldest element */
+    RingBufDma_sync(&rbd);
+    VERIFY(1U == rbd.overruns);
+    RingBufDma_flush(&rbd);
+    VERIFY(false == RingBuf_get(&rbd.rb, &el));
+    sim_dma(&rbd, 1U, 0xD0U);
+    RingBufDma_sync(&rbd);
+    VERIFY(true == RingBuf_get(&rbd.rb, &el));
+    VERIFY(0xD0U == el);
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: simulated DMA engine thread and consumer", 1000000U, 0U) {
+    sim_ndtr = ARRAY_NELEM(big_buf);
+    RingBufDma_ctor(&big_rbd, big_buf, ARRAY_NELEM(big_buf), &sim_ndtr);
+    n_errors = 0U;
+    ET_perf_worker(&dma_engine_worker, &big_rbd, 0);
+    ET_perf_worker(&dma_consumer_worker, &big_rbd, 1);
+    ET_perf_run();
+    VERIFY(0U == n_errors);
+    VERIFY(0U == big_rbd.overruns);
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+static void sim_dma(RingBufDma * const dma, uint32_t n, RingBufElement el) {
+    RingBufCtr const len = dma->rb.end;
+    for (; n != 0U; --n, ++el) {
+        uint32_t const ndtr =
+            atomic_load_explicit(&sim_ndtr, memory_order_relaxed);
+        dma->rb.buf[len - ndtr] = el;
+        /* the release store publishes the element before the count */
+        atomic_store_explicit(&sim_ndtr,
+            (ndtr > 1U) ? (ndtr - 1U) : len, /* reload */
+            memory_order_release);
+    }
+}
+
+#ifdef Q_HOST
+/* the simulated DMA engine: bursts of up to 64 elements, paced like
+* a flow-controlled UART (the engine waits for space in the ring),
+* so that the test does not depend on the thread scheduling
+*/
+static unsigned long dma_engine_worker(void *arg, unsigned long n_ops) {
+    RingBufDma * const me = (RingBufDma *)arg;
+    RingBufCtr const len = me->rb.end;
+    unsigned long n = 0U;
+    while (n < n_ops) {
+        unsigned long burst = n_ops - n;
+        if (burst > 64U) {
+            burst = 64U;
+        }
+        /* free space from the DMA position and the consumer's tail */
+        RingBufCtr const head = (RingBufCtr)(len
+            - atomic_load_explicit(&sim_ndtr, memory_order_relaxed));
+        RingBufCtr const tail =
+            atomic_load_explicit(&me->rb.tail, memory_order_acquire);
+        RingBufCtr const used = (head >= tail)
+                                ? (RingBufCtr)(head - tail)
+                                : (RingBufCtr)(len + head - tail);
+        if (used + burst <= (unsigned long)len - 1U) {
+            sim_dma(me, (uint32_t)burst, (RingBufElement)n);
+            n += burst;
+        }
+    }
+    return n_ops;
+}
+
+static unsigned long dma_consumer_worker(void *arg, unsigned long n_ops) {
+    RingBufDma * const me = (RingBufDma *)arg;
+    unsigned long n = 0U;
+    while (n < n_ops) {
+        RingBufDma_sync(me); /* the consumer is the only caller of sync */
+        RingBufElement el;
+        while (RingBuf_get(&me->rb, &el)) {
+            if ((RingBufElement)n != el) {
+                ++n_errors;
+            }
+            ++n;
+        }
+    }
+    return 0U; /* the transfers are counted by the DMA engine */
+}
+#endif /* Q_HOST */
@@ -0,0 +1,96 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_buf_host.h"
+#include "et.h" /* ET: embedded test */
+
+/* 3MB of uint8_t elements, which spans two 2MB chunks */
+#define HOST_LEN ((RingBufCtr)(RING_BUF_CTR_SIZE >= 4U ? 0x300000U : 0xFFFFU))
+
+static RingBuf rb;
+static RingBufHostCfg const *l_cfg; /* configuration of rb */
+
+/* fill the whole ring and drain it, verifying the elements */
+static bool fill_and_drain(RingBuf * const me);
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+    RingBuf_host_xtor(&rb, l_cfg);
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("ring buffer host storage") {
+
+TEST("RingBuf_host_ctor default pages") {
+    static RingBufHostCfg const cfg = {
+        RING_BUF_PAGES_DEFAULT, false, RING_BUF_NUMA_ANY
+    };
+    l_cfg = &cfg;
+    VERIFY(true == RingBuf_host_ctor(&rb, HOST_LEN, &cfg));
+    VERIFY(RingBuf_num_free(&rb) == HOST_LEN - 1U);
+    VERIFY(fill_and_drain(&rb));
+}
+
+TEST("RingBuf_host_ctor THP prefault") {
+    static RingBufHostCfg const cfg = {
+        RING_BUF_PAGES_THP, true, RING_BUF_NUMA_ANY
+    };
+    l_cfg = &cfg;
+    VERIFY(true == RingBuf_host_ctor(&rb, HOST_LEN, &cfg));
+    VERIFY(fill_and_drain(&rb));
+}
+
+TEST("RingBuf_host_ctor HUGETLB (or fallback) local NUMA node") {
+    static RingBufHostCfg const cfg = {
+        RING_BUF_PAGES_HUGETLB, true, RING_BUF_NUMA_LOCAL
+    };
+    l_cfg = &cfg;
+    VERIFY(true == RingBuf_host_ctor(&rb, HOST_LEN, &cfg));
+    VERIFY(fill_and_drain(&rb));
+}
+
+TEST("RingBuf_host_ctor NUMA node 0") {
+    static RingBufHostCfg const cfg = {
+        RING_BUF_PAGES_THP, false, 0
+    };
+    l_cfg = &cfg;
+    VERIFY(true == RingBuf_host_ctor(&rb, 8U, &cfg));
+    VERIFY(fill_and_drain(&rb));
+}
+
+} /* TEST_GROUP() */
+
+static bool fill_and_drain(RingBuf * const me) {
+    RingBufCtr i;
+    for (i = 0U; RingBuf_put(me, (RingBufElement)i); ++i) {
+    }
+    if (i != me->end - 1U) {
+        return false;
+    }
+    for (i = 0U; i < me->end - 1U; ++i) {
+        RingBufElement el;
+        if (!RingBuf_get(me, &el) || (el != (RingBufElement)i)) {
+            return false;
+        }
+    }
+    return RingBuf_num_free(me) == me->end - 1U;
+}
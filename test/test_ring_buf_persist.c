@@ -0,0 +1,199 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#ifdef Q_HOST
+#define _GNU_SOURCE /* for fork(), waitpid(), unlink() */
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buf.h"
+#include "ring_buf_persist.h"
+#include "et.h" /* ET: embedded test */
+
+#ifdef Q_HOST
+#include "ring_buf_host.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
+
+/* on the MCU, the ring buffer would be in the no-init RAM:
+* static RingBufElement sto[16] RING_BUF_NOINIT;
+* static RingBufPersist prb RING_BUF_NOINIT;
+*/
+static RingBufElement sto[16];
+static RingBufPersist prb;
+
+/* initialize the persistent ring buffer from garbage memory */
+static void cold_start(void);
+
+#ifdef Q_HOST
+/* unique path of the memory-mapped file for the given test */
+static void file_path(char *path, size_t size, char const *name);
+
+/* performance test worker */
+static unsigned long put_get_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("persistent ring buffer") {
+
+TEST("RingBufPersist_init cold start (garbage memory)") {
+    memset(&prb, 0xA5, sizeof(prb));
+    VERIFY(false == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(RingBuf_num_free(&prb.rb) == ARRAY_NELEM(sto) - 1U);
+    VERIFY(0U == prb.n_recovered);
+
+    /* garbage with the valid magic, but with a stale check */
+    prb.magic = RING_BUF_PERSIST_MAGIC;
+    prb.check = 0xA5A5A5A5U;
+    VERIFY(false == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+}
+
+TEST("RingBufPersist_init recovery after reset") {
+    RingBufElement el;
+    cold_start();
+    for (RingBufElement i = 0U; i < 20U; ++i) { /* wrap around */
+        RingBuf_put(&prb.rb, i);
+        if (i < 15U) {
+            RingBuf_get(&prb.rb, &el);
+        }
+    }
+    prb.rb.buf = (RingBufElement *)0; /* e.g., different address */
+    VERIFY(true == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(1U == prb.n_recovered);
+    for (RingBufElement i = 15U; i < 20U; ++i) {
+        VERIFY(true == RingBuf_get(&prb.rb, &el));
+        VERIFY(i == el);
+    }
+    VERIFY(false == RingBuf_get(&prb.rb, &el));
+
+    /* the second recovery */
+    VERIFY(true == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(2U == prb.n_recovered);
+}
+
+TEST("RingBufPersist_init rejects corrupted indices and geometry") {
+    cold_start();
+    atomic_store(&prb.rb.head, ARRAY_NELEM(sto)); /* out of range */
+    VERIFY(false == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(true == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(false == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto) - 1U));
+}
+
+TEST("RingBufPersist_init rejects corrupted header words") {
+    cold_start();
+    prb.check ^= 1U; /* the correct length, but a corrupted check */
+    VERIFY(false == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(0U == prb.n_recovered);
+
+    cold_start();
+    prb.n_recovered ^= 4U; /* covered by the check */
+    VERIFY(false == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(0U == prb.n_recovered);
+
+    cold_start();
+    prb.rb.end = ARRAY_NELEM(sto) - 1U; /* inconsistent with len */
+    VERIFY(false == RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto)));
+    VERIFY(ARRAY_NELEM(sto) == prb.rb.end);
+}
+
+#ifdef Q_HOST
+TEST("RingBuf_host_persist survives the crash of the process") {
+    char path[64];
+    RingBufPersist *fprb;
+    bool recovered;
+    file_path(path, sizeof(path), "crash");
+
+    pid_t const pid = fork();
+    if (pid == 0) { /* child: put 5 elements and crash */
+        fprb = RingBuf_host_persist(path, 1000U, &recovered);
+        if ((fprb == (RingBufPersist *)0) || recovered) {
+            _exit(1);
+        }
+        for (RingBufElement i = 0U; i < 5U; ++i) {
+            RingBuf_put(&fprb->rb, 0xC0U + i);
+        }
+        abort(); /* no close, no msync */
+    }
+    int status;
+    VERIFY(pid == waitpid(pid, &status, 0));
+    VERIFY(WIFSIGNALED(status)); /* the child crashed */
+
+    fprb = RingBuf_host_persist(path, 1000U, &recovered);
+    VERIFY(fprb != (RingBufPersist *)0);
+    VERIFY(true == recovered);
+    RingBufElement el;
+    for (RingBufElement i = 0U; i < 5U; ++i) {
+        VERIFY(true == RingBuf_get(&fprb->rb, &el));
+        VERIFY((RingBufElement)(0xC0U + i) == el);
+    }
+    VERIFY(false == RingBuf_get(&fprb->rb, &el));
+    RingBuf_host_persist_close(fprb);
+    (void)unlink(path);
+}
+
+PERF_TEST("perf: RingBuf_put/get in a memory-mapped file", 10000000U, 0U) {
+    char path[64];
+    bool recovered;
+    file_path(path, sizeof(path), "perf");
+    RingBufPersist * const fprb =
+        RingBuf_host_persist(path, 1000U, &recovered);
+    VERIFY(fprb != (RingBufPersist *)0);
+    VERIFY(false == recovered);
+    ET_perf_worker(&put_get_worker, &fprb->rb, 0);
+    ET_perf_run();
+    RingBuf_host_persist_close(fprb);
+    (void)unlink(path);
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+static void cold_start(void) {
+    memset(&prb, 0xA5, sizeof(prb));
+    (void)RingBufPersist_init(&prb, sto, ARRAY_NELEM(sto));
+}
+
+#ifdef Q_HOST
+static void file_path(char *path, size_t size, char const *name) {
+    snprintf(path, size, "/tmp/test_ring_buf_persist_%s_%d.bin",
+             name, (int)getpid());
+    (void)unlink(path);
+}
+
+static unsigned long put_get_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += 2U) {
+        RingBufElement el;
+        RingBuf_put(me, (RingBufElement)n);
+        RingBuf_get(me, &el);
+    }
+    return n;
+}
+#endif /* Q_HOST */
@@ -0,0 +1,159 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_buf_timed.h"
+#include "et.h" /* ET: embedded test */
+
+static RingBufElement buf[8];
+static RingBufTime ts_buf[8];
+static RingBufTimed rbt;
+
+/* fake clock for the tests */
+static RingBufTime fake_now;
+static RingBufTime fake_clock(void);
+
+#ifdef Q_HOST
+#define BIG_LEN 4096U
+static RingBufElement big_buf[BIG_LEN];
+static RingBufTime big_ts[BIG_LEN];
+static RingBufTimed big_rbt;
+
+/* performance test workers */
+static unsigned long expire_worker(void *arg, unsigned long n_ops);
+static unsigned long get_discard_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("time-stamped ring buffer") {
+
+RingBufTimed_ctor(&rbt, buf, ts_buf, ARRAY_NELEM(buf), &fake_clock);
+
+TEST("RingBufTimed_put stamps the elements") {
+    RingBufElement el;
+    RingBufTime ts;
+    fake_now = 100U;
+    VERIFY(true == RingBufTimed_put(&rbt, 0xAAU));
+    fake_now = 105U;
+    VERIFY(true == RingBufTimed_put(&rbt, 0xBBU));
+    VERIFY(true == RingBufTimed_get(&rbt, &el, &ts));
+    VERIFY((0xAAU == el) && (100U == ts));
+    VERIFY(true == RingBufTimed_get(&rbt, &el, &ts));
+    VERIFY((0xBBU == el) && (105U == ts));
+    VERIFY(false == RingBufTimed_get(&rbt, &el, &ts));
+}
+
+TEST("RingBufTimed_expire discards the old elements at once") {
+    RingBufElement el;
+    RingBufTime ts;
+    /* 7 elements at t = 10..16, wrapping around the end of the buffer */
+    for (RingBufElement i = 0U; i < 7U; ++i) {
+        fake_now = 10U + i;
+        VERIFY(true == RingBufTimed_put(&rbt, i));
+    }
+    fake_now = 20U;
+    VERIFY(0U == RingBufTimed_expire(&rbt, 10U)); /* nothing older */
+    VERIFY(4U == RingBufTimed_expire(&rbt, 6U));  /* t = 10..13 */
+    VERIFY(RingBuf_num_free(&rbt.rb) == ARRAY_NELEM(buf) - 1U - 3U);
+    VERIFY(true == RingBufTimed_get(&rbt, &el, &ts));
+    VERIFY((4U == el) && (14U == ts));
+    VERIFY(2U == RingBufTimed_expire(&rbt, 0U)); /* all */
+    VERIFY(false == RingBufTimed_get(&rbt, &el, &ts));
+    VERIFY(0U == RingBufTimed_expire(&rbt, 0U)); /* empty */
+}
+
+TEST("RingBufTimed_expire clock wrap-around") {
+    RingBufElement el;
+    RingBufTime ts;
+    for (RingBufElement i = 0U; i < 4U; ++i) {
+        fake_now = (RingBufTime)(-2) + i; /* ...FE, ...FF, 0, 1 */
+        RingBufTimed_put(&rbt, i);
+    }
+    fake_now = 3U;
+    VERIFY(2U == RingBufTimed_expire(&rbt, 3U));
+    VERIFY(true == RingBufTimed_get(&rbt, &el, &ts));
+    VERIFY((2U == el) && (0U == ts));
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: RingBufTimed_expire of 4095 elements", 0U, 100U) {
+    RingBufTimed_ctor(&big_rbt, big_buf, big_ts, BIG_LEN, &fake_clock);
+    ET_perf_worker(&expire_worker, &big_rbt, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: RingBufTimed_get discard of 4095 elements", 0U, 100U) {
+    RingBufTimed_ctor(&big_rbt, big_buf, big_ts, BIG_LEN, &fake_clock);
+    ET_perf_worker(&get_discard_worker, &big_rbt, 0);
+    ET_perf_run();
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+static RingBufTime fake_clock(void) {
+    return fake_now;
+}
+
+#ifdef Q_HOST
+/* The workers refill the ring buffer by moving the producer's head index
+* (no per-element puts, all time stamps stay 0), so that the ops/s measure
+* only the discarding of the whole ring buffer. Every op discards
+* BIG_LEN - 1 expired elements.
+*/
+static void refill(RingBufTimed * const me) {
+    RingBufCtr const tail =
+        atomic_load_explicit(&me->rb.tail, memory_order_relaxed);
+    atomic_store_explicit(&me->rb.head,
+        (RingBufCtr)((tail == 0U) ? (BIG_LEN - 1U) : (tail - 1U)),
+        memory_order_release);
+}
+
+static unsigned long expire_worker(void *arg, unsigned long n_ops) {
+    RingBufTimed * const me = (RingBufTimed *)arg;
+    unsigned long n;
+    fake_now = 1000U;
+    for (n = 0U; (n < n_ops) && !ET_perf_stop(); ++n) {
+        refill(me);
+        VERIFY(BIG_LEN - 1U == RingBufTimed_expire(me, 10U));
+    }
+    return n;
+}
+
+static unsigned long get_discard_worker(void *arg, unsigned long n_ops) {
+    RingBufTimed * const me = (RingBufTimed *)arg;
+    unsigned long n;
+    fake_now = 1000U;
+    for (n = 0U; (n < n_ops) && !ET_perf_stop(); ++n) {
+        RingBufElement el;
+        RingBufTime ts;
+        refill(me);
+        while (RingBufTimed_get(me, &el, &ts)
+               && ((RingBufTime)(fake_now - ts) > 10U)) {
+        }
+    }
+    return n;
+}
+#endif /* Q_HOST */
@@ -0,0 +1,124 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buf.h"
+#include "ring_crc.h"
+#include "et.h" /* ET: embedded test */
+
+static RingBufElement sto[1000];
+static RingBuf rb;
+static uint8_t pkt[256];
+static uint8_t buf[256];
+static uint32_t crc_out;
+
+/* performance test workers */
+static unsigned long two_pass_worker(void *arg, unsigned long n_ops);
+static unsigned long one_pass_worker(void *arg, unsigned long n_ops);
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    RingBuf_ctor(&rb, sto, ARRAY_NELEM(sto));
+    for (unsigned i = 0U; i < sizeof(pkt); ++i) {
+        pkt[i] = (uint8_t)(i * 37U + 11U);
+    }
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("CRC while draining the ring buffer") {
+
+TEST("RingCrc check values") {
+    static uint8_t const chk[] = "123456789";
+    VERIFY(0xE3069283U == RingCrc_crc32c(0U, chk, 9U));
+    VERIFY(0x906EU == RingCrc_crc16(0U, chk, 9U));
+    /* chaining */
+    VERIFY(0xE3069283U == RingCrc_crc32c(RingCrc_crc32c(0U, chk, 4U),
+                                         &chk[4], 5U));
+    VERIFY(0x906EU == RingCrc_crc16(RingCrc_crc16(0U, chk, 4U),
+                                    &chk[4], 5U));
+    VERIFY(0U == RingCrc_crc32c(0U, chk, 0U));
+}
+
+TEST("RingBuf_get_n_crc32c/crc16 wrap-around") {
+    for (RingBufCtr pos = ARRAY_NELEM(sto) - 300U; pos < ARRAY_NELEM(sto);
+         pos += 23U)
+    {
+        atomic_store(&rb.head, pos);
+        atomic_store(&rb.tail, pos);
+        VERIFY(sizeof(pkt) == RingBuf_put_n(&rb, pkt, sizeof(pkt)));
+        VERIFY(sizeof(pkt) == RingBuf_put_n(&rb, pkt, sizeof(pkt)));
+
+        uint32_t crc32 = 0U;
+        uint16_t crc16 = 0U;
+        memset(buf, 0, sizeof(buf));
+        VERIFY(100U == RingBuf_get_n_crc32c(&rb, buf, 100U, &crc32));
+        VERIFY(sizeof(pkt) - 100U
+               == RingBuf_get_n_crc32c(&rb, &buf[100], sizeof(pkt) - 100U,
+                                       &crc32));
+        VERIFY(0 == memcmp(buf, pkt, sizeof(pkt)));
+        VERIFY(RingCrc_crc32c(0U, pkt, sizeof(pkt)) == crc32);
+
+        memset(buf, 0, sizeof(buf));
+        VERIFY(sizeof(pkt)
+               == RingBuf_get_n_crc16(&rb, buf, sizeof(buf) + 9U, &crc16));
+        VERIFY(0 == memcmp(buf, pkt, sizeof(pkt)));
+        VERIFY(RingCrc_crc16(0U, pkt, sizeof(pkt)) == crc16);
+        VERIFY(0U == RingBuf_get_n_crc16(&rb, buf, 1U, &crc16));
+        VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(sto) - 1U);
+    }
+}
+
+PERF_TEST("perf: RingBuf_get_n() + RingCrc_crc32c() [bytes]",
+          10000000U, 0U)
+{
+    ET_perf_worker(&two_pass_worker, &rb, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: RingBuf_get_n_crc32c() [bytes]", 10000000U, 0U) {
+    ET_perf_worker(&one_pass_worker, &rb, 0);
+    ET_perf_run();
+}
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+static unsigned long two_pass_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += sizeof(pkt)) {
+        RingBuf_put_n(me, pkt, sizeof(pkt));
+        RingBufCtr const k = RingBuf_get_n(me, buf, sizeof(buf));
+        crc_out = RingCrc_crc32c(0U, buf, k);
+    }
+    return n;
+}
+static unsigned long one_pass_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += sizeof(pkt)) {
+        RingBuf_put_n(me, pkt, sizeof(pkt));
+        uint32_t crc = 0U;
+        RingBuf_get_n_crc32c(me, buf, sizeof(buf), &crc);
+        crc_out = crc;
+    }
+    return n;
+}
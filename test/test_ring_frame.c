@@ -0,0 +1,179 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buf.h"
+#include "ring_frame.h"
+#include "et.h" /* ET: embedded test */
+
+static RingBufElement sto[300];
+static RingBuf rb;
+static uint8_t dec_buf[256];
+static RingFrameDec dec;
+
+static uint8_t payload[256];
+static size_t rx_len;
+static uint8_t rx[256];
+static unsigned rx_count;
+
+/* performance test worker */
+static unsigned long frame_worker(void *arg, unsigned long n_ops);
+
+static void on_frame(uint8_t const *frame, size_t len, void *ctx) {
+    (void)ctx;
+    rx_len = len;
+    memcpy(rx, frame, len);
+    ++rx_count;
+}
+static void on_frame_perf(uint8_t const *frame, size_t len, void *ctx) {
+    *(size_t *)ctx += len + frame[0] * 0U;
+}
+/* round-trip of one frame */
+static bool round_trip(uint8_t const kind, size_t n) {
+    rx_len = ~(size_t)0;
+    if (!RingFrame_put(&rb, kind, payload, n)) {
+        return false;
+    }
+    if (RingFrameDec_process(&dec, &rb, &on_frame, (void *)0) != 1U) {
+        return false;
+    }
+    return (rx_len == n) && (memcmp(rx, payload, n) == 0);
+}
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    RingBuf_ctor(&rb, sto, ARRAY_NELEM(sto));
+    RingFrameDec_ctor(&dec, RING_FRAME_HDLC, dec_buf, sizeof(dec_buf));
+    rx_count = 0U;
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("HDLC/COBS framing") {
+
+TEST("RingFrame_put HDLC stuffing and FCS") {
+    static uint8_t const pl[] = { 0x01U, 0x7EU, 0x7DU };
+    uint8_t out[16];
+    VERIFY(true == RingFrame_put(&rb, RING_FRAME_HDLC, pl, sizeof(pl)));
+    RingBufCtr const n = RingBuf_get_n(&rb, out, sizeof(out));
+    VERIFY(n >= 8U);
+    VERIFY(0x7EU == out[0]);
+    VERIFY((0x01U == out[1]) && (0x7DU == out[2]) && (0x5EU == out[3])
+           && (0x7DU == out[4]) && (0x5DU == out[5]));
+    VERIFY(0x7EU == out[n - 1U]);
+}
+
+TEST("RingFrame_put COBS reference encodings") {
+    uint8_t out[300];
+    static uint8_t const pl1[] = { 0x11U, 0x22U, 0x00U, 0x33U };
+    VERIFY(true == RingFrame_put(&rb, RING_FRAME_COBS, pl1, sizeof(pl1)));
+    VERIFY(6U == RingBuf_get_n(&rb, out, sizeof(out)));
+    VERIFY(0 == memcmp(out, "\x03\x11\x22\x02\x33\x00", 6U));
+
+    static uint8_t const pl2[] = { 0x00U };
+    VERIFY(true == RingFrame_put(&rb, RING_FRAME_COBS, pl2, sizeof(pl2)));
+    VERIFY(3U == RingBuf_get_n(&rb, out, sizeof(out)));
+    VERIFY(0 == memcmp(out, "\x01\x01\x00", 3U));
+
+    for (unsigned i = 0U; i < 254U; ++i) {
+        payload[i] = (uint8_t)(i + 1U);
+    }
+    VERIFY(true == RingFrame_put(&rb, RING_FRAME_COBS, payload, 254U));
+    VERIFY(256U == RingBuf_get_n(&rb, out, sizeof(out)));
+    VERIFY((0xFFU == out[0]) && (0x01U == out[1]) && (0xFEU == out[254])
+           && (0x00U == out[255]));
+}
+
+TEST("RingFrame round-trip through wrap-around (HDLC and COBS)") {
+    uint32_t seed = 1U;
+    for (unsigned kind = RING_FRAME_HDLC; kind <= RING_FRAME_COBS; ++kind) {
+        RingFrameDec_ctor(&dec, (uint8_t)kind, dec_buf, sizeof(dec_buf));
+        for (unsigned k = 0U; k < 200U; ++k) {
+            size_t const n = (k * 7U) % 120U;
+            for (size_t i = 0U; i < n; ++i) {
+                seed = seed * 1664525U + 1013904223U;
+                /* plenty of the bytes that need stuffing */
+                payload[i] = ((seed >> 28) == 0U) ? 0x00U
+                             : ((seed >> 28) == 1U) ? 0x7EU
+                             : ((seed >> 28) == 2U) ? 0x7DU
+                             : (uint8_t)(seed >> 16);
+            }
+            VERIFY(round_trip((uint8_t)kind, n));
+        }
+        VERIFY(200U == dec.n_frames);
+        VERIFY(0U == dec.n_errors);
+    }
+}
+
+TEST("RingFrame_put frame that does not fit") {
+    memset(payload, 0x7EU, sizeof(payload)); /* doubles in size */
+    VERIFY(false == RingFrame_put(&rb, RING_FRAME_HDLC, payload, 200U));
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(sto) - 1U);
+    VERIFY(true == RingFrame_put(&rb, RING_FRAME_HDLC, payload, 100U));
+}
+
+TEST("RingFrameDec_process drops corrupted frames") {
+    static uint8_t const pl[] = { 0x10U, 0x20U, 0x30U };
+    VERIFY(true == RingFrame_put(&rb, RING_FRAME_HDLC, pl, sizeof(pl)));
+    rb.buf[2] ^= 0x01U; /* corrupt the payload */
+    VERIFY(true == RingFrame_put(&rb, RING_FRAME_HDLC, pl, sizeof(pl)));
+    VERIFY(1U == RingFrameDec_process(&dec, &rb, &on_frame, (void *)0));
+    VERIFY(1U == dec.n_errors);
+    VERIFY((3U == rx_len) && (0 == memcmp(rx, pl, 3U)));
+
+    /* incomplete frame stays in the ring buffer */
+    RingBuf_put(&rb, 0x7EU);
+    RingBuf_put(&rb, 0x10U);
+    VERIFY(0U == RingFrameDec_process(&dec, &rb, &on_frame, (void *)0));
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(sto) - 2U);
+}
+
+PERF_TEST("perf: HDLC encode + decode 200-byte frames [bytes]",
+          10000000U, 0U)
+{
+    RingFrameDec_ctor(&dec, RING_FRAME_HDLC, dec_buf, sizeof(dec_buf));
+    ET_perf_worker(&frame_worker, &dec, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: COBS encode + decode 200-byte frames [bytes]",
+          10000000U, 0U)
+{
+    RingFrameDec_ctor(&dec, RING_FRAME_COBS, dec_buf, sizeof(dec_buf));
+    ET_perf_worker(&frame_worker, &dec, 0);
+    ET_perf_run();
+}
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+static unsigned long frame_worker(void *arg, unsigned long n_ops) {
+    RingFrameDec * const me = (RingFrameDec *)arg;
+    for (size_t i = 0U; i < 200U; ++i) { /* ~1% of the bytes stuffed */
+        payload[i] = ((i % 97U) == 0U) ? 0x00U
+                     : ((i % 89U) == 0U) ? 0x7EU : (uint8_t)(i | 0x80U);
+    }
+    size_t n = 0U;
+    while (n < n_ops) {
+        RingFrame_put(&rb, me->kind, payload, 200U);
+        RingFrameDec_process(me, &rb, &on_frame_perf, &n);
+    }
+    return n;
+}
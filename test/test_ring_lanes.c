@@ -0,0 +1,183 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_lanes.h"
+#include "et.h" /* ET: embedded test */
+
+#define CTRL 0U /* control lane (highest priority) */
+#define BULK 1U /* bulk-data lane */
+
+static RingBufElement ctrl_buf[8];
+static RingBufElement bulk_buf[32];
+static RingLanes rl;
+
+/* multi-lane "handler" function for RingLanes_process_all() */
+static void rl_handler(uint8_t const lane, RingBufElement const el);
+
+static uint8_t  test_lane[16];
+static unsigned test_n;
+
+#ifdef Q_HOST
+/* performance test workers */
+static unsigned long put_get_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("multi-lane ring") {
+
+RingLanes_ctor(&rl, RING_LANES_STRICT);
+RingLanes_add(&rl, ctrl_buf, ARRAY_NELEM(ctrl_buf), 1U);
+RingLanes_add(&rl, bulk_buf, ARRAY_NELEM(bulk_buf), 3U);
+
+TEST("RingLanes strict: control before queued bulk") {
+    uint8_t lane;
+    RingBufElement el;
+    for (RingBufElement i = 0U; i < 10U; ++i) {
+        VERIFY(true == RingLanes_put(&rl, BULK, i));
+    }
+    VERIFY(true == RingLanes_get(&rl, &lane, &el));
+    VERIFY((BULK == lane) && (0U == el));
+    VERIFY(true == RingLanes_put(&rl, CTRL, 0xCCU));
+    VERIFY(true == RingLanes_get(&rl, &lane, &el));
+    VERIFY((CTRL == lane) && (0xCCU == el));
+    VERIFY(true == RingLanes_get(&rl, &lane, &el));
+    VERIFY((BULK == lane) && (1U == el));
+}
+
+TEST("RingLanes strict: process_all") {
+    RingLanes_put(&rl, CTRL, 0xC1U);
+    RingLanes_put(&rl, CTRL, 0xC2U);
+    test_n = 0U;
+    RingLanes_process_all(&rl, &rl_handler);
+    VERIFY(10U == test_n); /* 2 control + 8 remaining bulk */
+    VERIFY((CTRL == test_lane[0]) && (CTRL == test_lane[1]));
+    for (unsigned i = 2U; i < test_n; ++i) {
+        VERIFY(BULK == test_lane[i]);
+    }
+}
+
+TEST("RingLanes statistics") {
+    RingLaneInfo info;
+    RingLanes_stats(&rl, BULK, &info);
+    VERIFY((10U == info.puts) && (10U == info.gets));
+    VERIFY((0U == info.drops) && (0U == info.used));
+    VERIFY(10U == info.hwm);
+
+    /* overflow the control lane */
+    for (unsigned i = 0U; i < ARRAY_NELEM(ctrl_buf) + 2U; ++i) {
+        RingLanes_put(&rl, CTRL, (RingBufElement)i);
+    }
+    RingLanes_stats(&rl, CTRL, &info);
+    VERIFY((3U + ARRAY_NELEM(ctrl_buf) - 1U) == info.puts);
+    VERIFY(3U == info.drops);
+    VERIFY((ARRAY_NELEM(ctrl_buf) - 1U) == info.used);
+    VERIFY((ARRAY_NELEM(ctrl_buf) - 1U) == info.hwm);
+    test_n = 0U;
+    RingLanes_process_all(&rl, &rl_handler);
+    RingLanes_stats(&rl, CTRL, &info);
+    VERIFY(0U == info.used);
+}
+
+TEST("RingLanes weighted round-robin") {
+    RingLanes_ctor(&rl, RING_LANES_WRR);
+    RingLanes_add(&rl, ctrl_buf, ARRAY_NELEM(ctrl_buf), 1U);
+    RingLanes_add(&rl, bulk_buf, ARRAY_NELEM(bulk_buf), 3U);
+    for (RingBufElement i = 0U; i < 4U; ++i) {
+        RingLanes_put(&rl, CTRL, i);
+    }
+    for (RingBufElement i = 0U; i < 8U; ++i) {
+        RingLanes_put(&rl, BULK, i);
+    }
+    test_n = 0U;
+    RingLanes_process_all(&rl, &rl_handler);
+    VERIFY(12U == test_n);
+    /* 1 control : 3 bulk per round, then the rest of the bulk lane */
+    static uint8_t const expected[] = {
+        CTRL, BULK, BULK, BULK, CTRL, BULK, BULK, BULK,
+        CTRL, BULK, BULK, CTRL
+    };
+    for (unsigned i = 0U; i < ARRAY_NELEM(expected); ++i) {
+        VERIFY(expected[i] == test_lane[i]);
+    }
+}
+
+TEST("RingLanes weighted round-robin, one lane busy") {
+    uint8_t lane;
+    RingBufElement el;
+    for (RingBufElement i = 0U; i < 5U; ++i) {
+        RingLanes_put(&rl, BULK, i);
+    }
+    for (RingBufElement i = 0U; i < 5U; ++i) {
+        VERIFY(true == RingLanes_get(&rl, &lane, &el));
+        VERIFY((BULK == lane) && (i == el));
+    }
+    VERIFY(false == RingLanes_get(&rl, &lane, &el));
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: RingLanes_put/get strict, bulk backlog", 10000000U, 0U) {
+    RingLanes_ctor(&rl, RING_LANES_STRICT);
+    RingLanes_add(&rl, ctrl_buf, ARRAY_NELEM(ctrl_buf), 1U);
+    RingLanes_add(&rl, bulk_buf, ARRAY_NELEM(bulk_buf), 3U);
+    ET_perf_worker(&put_get_worker, &rl, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: RingLanes_put/get WRR, bulk backlog", 10000000U, 0U) {
+    RingLanes_ctor(&rl, RING_LANES_WRR);
+    RingLanes_add(&rl, ctrl_buf, ARRAY_NELEM(ctrl_buf), 1U);
+    RingLanes_add(&rl, bulk_buf, ARRAY_NELEM(bulk_buf), 3U);
+    ET_perf_worker(&put_get_worker, &rl, 0);
+    ET_perf_run();
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+static void rl_handler(uint8_t const lane, RingBufElement const el) {
+    (void)el;
+    if (test_n < ARRAY_NELEM(test_lane)) {
+        test_lane[test_n] = lane;
+    }
+    ++test_n;
+}
+
+#ifdef Q_HOST
+/* one control element per 4 bulk elements, with the bulk lane kept full */
+static unsigned long put_get_worker(void *arg, unsigned long n_ops) {
+    RingLanes * const me = (RingLanes *)arg;
+    unsigned long n;
+    uint8_t lane;
+    RingBufElement el;
+    while (RingLanes_put(me, BULK, 0U)) {
+    }
+    for (n = 0U; n < n_ops; n += 2U) {
+        RingLanes_put(me, ((n & 7U) == 0U) ? CTRL : BULK, (RingBufElement)n);
+        RingLanes_get(me, &lane, &el);
+    }
+    return n;
+}
+#endif /* Q_HOST */
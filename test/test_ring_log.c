@@ -0,0 +1,186 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_log.h"
+#include "et.h" /* ET: embedded test */
+
+#ifdef Q_HOST
+#include <stdio.h> /* for snprintf() in the performance comparison */
+#endif
+
+/* format strings, indexed by the log IDs */
+enum LogIds { LOG_BOOT, LOG_ADC, LOG_HEX, LOG_CHAR, LOG_WIDTH, N_LOG_IDS };
+static char const * const log_fmts[N_LOG_IDS] = {
+    "boot\n",
+    "ADC ch=%u val=%d\n",
+    "reg[%02x]=0x%08X\n",
+    "%c%c 100%%\n",
+    "[%5d][%05d][%3u]\n",
+};
+
+static RingBufElement buf[64];
+static RingLog rl;
+
+/* formatted output collected by the test */
+static char out[128];
+static unsigned out_len;
+static void out_putc(char const ch, void *ctx);
+static bool out_equals(char const *str);
+
+#ifdef Q_HOST
+/* performance test workers */
+static unsigned long ring_log_worker(void *arg, unsigned long n_ops);
+static unsigned long snprintf_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    out_len = 0U;
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("deferred binary logger") {
+
+RingLog_ctor(&rl, buf, ARRAY_NELEM(buf));
+
+TEST("RING_LOG records and deferred formatting") {
+    VERIFY(true == RING_LOG0(&rl, LOG_BOOT));
+    VERIFY(true == RING_LOG(&rl, LOG_ADC, 3U, (uint32_t)-42));
+    VERIFY(true == RING_LOG(&rl, LOG_HEX, 0x1FU, 0xDEADBEEFU));
+    VERIFY(true == RING_LOG(&rl, LOG_CHAR, 'O', 'K'));
+    RingLog_process_all(&rl, log_fmts, N_LOG_IDS, &out_putc, (void *)0);
+    VERIFY(out_equals("boot\n"
+                      "ADC ch=3 val=-42\n"
+                      "reg[1f]=0xDEADBEEF\n"
+                      "OK 100%\n"));
+    VERIFY(RingBuf_num_free(&rl.rb) == ARRAY_NELEM(buf) - 1U);
+}
+
+TEST("RingLog_format width of negative numbers (as printf)") {
+    VERIFY(true == RING_LOG(&rl, LOG_WIDTH, (uint32_t)-3, (uint32_t)-3, 7U));
+    VERIFY(true == RING_LOG(&rl, LOG_WIDTH, (uint32_t)-12345, 42U, 1234U));
+    RingLog_process_all(&rl, log_fmts, N_LOG_IDS, &out_putc, (void *)0);
+    VERIFY(out_equals("[   -3][-0003][  7]\n"
+                      "[-12345][00042][1234]\n"));
+}
+
+TEST("RingLog_read rejects a corrupted record") {
+    RingLogRec rec;
+    /* header with more argument words than RING_LOG_MAX_ARGS */
+    RingBufElement const bad[] = { RING_LOG_MAX_ARGS + 1U, 0U, 0U, 1U, 2U };
+    VERIFY(ARRAY_NELEM(bad) == RingBuf_put_n(&rl.rb, bad, ARRAY_NELEM(bad)));
+    VERIFY(false == RingLog_read(&rl, &rec));
+    VERIFY(RingBuf_num_free(&rl.rb) == ARRAY_NELEM(buf) - 1U); /* flushed */
+    VERIFY(true == RING_LOG(&rl, LOG_ADC, 1U, 2U)); /* back in sync */
+    VERIFY(true == RingLog_read(&rl, &rec));
+    VERIFY((LOG_ADC == rec.id) && (1U == rec.args[0]));
+}
+
+TEST("RingLog_read raw record (host-side decoding)") {
+    RingLogRec rec;
+    VERIFY(true == RING_LOG(&rl, LOG_ADC, 7U, 1000U));
+    VERIFY(true == RingLog_read(&rl, &rec));
+    VERIFY((LOG_ADC == rec.id) && (2U == rec.n_args));
+    VERIFY((7U == rec.args[0]) && (1000U == rec.args[1]));
+    VERIFY(false == RingLog_read(&rl, &rec));
+}
+
+TEST("RingLog drops whole records when full") {
+    /* every record takes 3 + 2*4 = 11 bytes, 63 bytes fit 5 records */
+    for (unsigned i = 0U; i < 7U; ++i) {
+        RING_LOG(&rl, LOG_ADC, i, i);
+    }
+    VERIFY(2U == rl.drops);
+    RingLog_process_all(&rl, log_fmts, N_LOG_IDS, &out_putc, (void *)0);
+    VERIFY(out_equals("ADC ch=0 val=0\nADC ch=1 val=1\nADC ch=2 val=2\n"
+                      "ADC ch=3 val=3\nADC ch=4 val=4\n"));
+}
+
+TEST("RingLog_write rejects too many arguments") {
+    RingLogRec rec;
+    static uint32_t const args[RING_LOG_MAX_ARGS + 1U];
+    uint32_t const drops = rl.drops;
+    VERIFY(false == RingLog_write(&rl, LOG_ADC,
+                                  (uint8_t)(RING_LOG_MAX_ARGS + 1U), args));
+    VERIFY(drops + 1U == rl.drops);
+    VERIFY(false == RingLog_read(&rl, &rec));
+    VERIFY(true == RingLog_write(&rl, LOG_ADC,
+                                 (uint8_t)RING_LOG_MAX_ARGS, args));
+    VERIFY(true == RingLog_read(&rl, &rec));
+    VERIFY(RING_LOG_MAX_ARGS == rec.n_args);
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: RING_LOG 2 args (deferred)", 10000000U, 0U) {
+    ET_perf_worker(&ring_log_worker, &rl, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: snprintf 2 args (in place)", 10000000U, 0U) {
+    ET_perf_worker(&snprintf_worker, (void *)0, 0);
+    ET_perf_run();
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+static void out_putc(char const ch, void *ctx) {
+    (void)ctx;
+    if (out_len < sizeof(out) - 1U) {
+        out[out_len++] = ch;
+        out[out_len] = '\0';
+    }
+}
+static bool out_equals(char const *str) {
+    unsigned i = 0U;
+    for (; (str[i] != '\0') && (i < out_len); ++i) {
+        if (str[i] != out[i]) {
+            return false;
+        }
+    }
+    return (str[i] == '\0') && (i == out_len);
+}
+
+#ifdef Q_HOST
+/* the producer logs, the "consumer" discards the records (not measured) */
+static unsigned long ring_log_worker(void *arg, unsigned long n_ops) {
+    RingLog * const me = (RingLog *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; ++n) {
+        RING_LOG(me, LOG_ADC, (uint32_t)n & 7U, (uint32_t)n);
+        if (RingBuf_num_free(&me->rb) < 11U) {
+            RingBuf_ctor(&me->rb, buf, ARRAY_NELEM(buf));
+        }
+    }
+    return n;
+}
+static unsigned long snprintf_worker(void *arg, unsigned long n_ops) {
+    (void)arg;
+    char line[64];
+    unsigned long n;
+    for (n = 0U; n < n_ops; ++n) {
+        snprintf(line, sizeof(line), log_fmts[LOG_ADC],
+                 (unsigned)(n & 7U), (int)n);
+    }
+    return n;
+}
+#endif /* Q_HOST */
@@ -0,0 +1,212 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buf.h"
+#include "ring_lz.h"
+#include "et.h" /* ET: embedded test */
+
+#define BLOCK 1024U
+
+static RingLz lz;
+static uint8_t lz_in[BLOCK];
+static uint8_t lz_out[BLOCK + 2U];
+
+static RingBufElement src_sto[4096];
+static RingBuf src;
+static RingBufElement dst_sto[4096];
+static RingBuf dst;
+
+static uint8_t data[8192];
+static uint8_t packed[8192 + 8192/255 + 16]; /* worst case */
+static uint8_t unpacked[8192];
+
+/* performance test workers */
+static unsigned long compress_worker(void *arg, unsigned long n_ops);
+static unsigned long decompress_worker(void *arg, unsigned long n_ops);
+
+/* telemetry records: time stamp, slowly varying readings, status */
+static void make_telemetry(uint8_t *p, size_t n) {
+    uint32_t t = 1000U;
+    uint16_t temp = 2150U;
+    uint16_t volt = 3300U;
+    for (size_t i = 0U; i + 12U <= n; i += 12U, t += 10U) {
+        if ((t % 70U) == 0U) {
+            ++temp;
+        }
+        volt = (uint16_t)(3300U + ((t / 10U) % 3U));
+        memcpy(&p[i], &t, 4U);
+        memcpy(&p[i + 4U], &temp, 2U);
+        memcpy(&p[i + 6U], &volt, 2U);
+        memcpy(&p[i + 8U], "\x01\x00\x00\x5A", 4U);
+    }
+}
+static bool round_trip(size_t n) {
+    size_t const len = RingLz_compress(&lz, data, n, packed, sizeof(packed));
+    if (len == 0U) {
+        return false;
+    }
+    return (RingLz_decompress(packed, len, unpacked, sizeof(unpacked)) == n)
+           && (memcmp(data, unpacked, n) == 0);
+}
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    RingLz_ctor(&lz, lz_in, lz_out, BLOCK);
+    RingBuf_ctor(&src, src_sto, ARRAY_NELEM(src_sto));
+    RingBuf_ctor(&dst, dst_sto, ARRAY_NELEM(dst_sto));
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("LZ compression stage") {
+
+TEST("RingLz_compress/decompress round-trip") {
+    uint32_t seed = 7U;
+    for (size_t n = 0U; n < 40U; ++n) { /* short blocks */
+        for (size_t i = 0U; i < n; ++i) {
+            data[i] = (uint8_t)(i % 3U);
+        }
+        VERIFY(round_trip(n));
+    }
+    memset(data, 0xAAU, sizeof(data)); /* long runs (overlapping copy) */
+    VERIFY(round_trip(sizeof(data)));
+    for (size_t i = 0U; i < sizeof(data); ++i) { /* random */
+        seed = seed * 1664525U + 1013904223U;
+        data[i] = (uint8_t)(seed >> 24);
+    }
+    VERIFY(round_trip(sizeof(data)));
+    VERIFY(0U == RingLz_compress(&lz, data, sizeof(data), packed, 4096U));
+    make_telemetry(data, sizeof(data));
+    VERIFY(round_trip(sizeof(data)));
+}
+
+TEST("RingLz_decompress rejects corrupted data") {
+    make_telemetry(data, 1000U);
+    size_t const len = RingLz_compress(&lz, data, 1000U,
+                                       packed, sizeof(packed));
+    VERIFY(len != 0U);
+    VERIFY(RING_LZ_ERROR == RingLz_decompress(packed, len, unpacked, 999U));
+    VERIFY(1000U != RingLz_decompress(packed, len - 1U, /* truncated */
+                                      unpacked, sizeof(unpacked)));
+    packed[0] = 0x0FU; /* match with no literals at the start */
+    packed[1] = 0x01U;
+    packed[2] = 0x00U;
+    VERIFY(RING_LZ_ERROR == RingLz_decompress(packed, len,
+                                              unpacked, sizeof(unpacked)));
+}
+
+TEST("RingLz_pump telemetry stream through the rings") {
+    make_telemetry(data, sizeof(data));
+    size_t n_in = 0U;
+    size_t n_out = 0U;
+    while (n_out < sizeof(data)) {
+        n_in += RingBuf_put_n(&src, &data[n_in],
+                              (RingBufCtr)(sizeof(data) - n_in));
+        while (RingLz_pump(&lz, &src, &dst, n_in == sizeof(data)) != 0U) {
+        }
+        size_t len;
+        while ((len = RingLz_read(&dst, packed, &unpacked[n_out],
+                                  sizeof(unpacked) - n_out)) != 0U)
+        {
+            VERIFY(len != RING_LZ_ERROR);
+            n_out += len;
+        }
+    }
+    VERIFY(sizeof(data) == n_out);
+    VERIFY(0 == memcmp(data, unpacked, sizeof(data)));
+    VERIFY(lz.n_raw == sizeof(data));
+    VERIFY(2U * lz.n_raw >= 3U * lz.n_packed); /* at least 1.5:1 */
+}
+
+TEST("RingLz_pump stores incompressible blocks raw") {
+    uint32_t seed = 3U;
+    for (size_t i = 0U; i < BLOCK; ++i) {
+        seed = seed * 1664525U + 1013904223U;
+        data[i] = (uint8_t)(seed >> 24);
+    }
+    RingBuf_put_n(&src, data, BLOCK);
+    VERIFY(BLOCK == RingLz_pump(&lz, &src, &dst, false));
+    VERIFY(BLOCK + 2U == lz.n_packed);
+    VERIFY(BLOCK == RingLz_read(&dst, packed, unpacked, BLOCK));
+    VERIFY(0 == memcmp(data, unpacked, BLOCK));
+    VERIFY(0U == RingLz_pump(&lz, &src, &dst, true)); /* nothing left */
+}
+
+TEST("RingLz_ctor clamps the block length") {
+    RingLz_ctor(&lz, lz_in, lz_out, 0U);
+    VERIFY(RING_LZ_MIN_BLOCK == lz.block_len);
+    VERIFY(0U == RingLz_pump(&lz, &src, &dst, true)); /* nothing to pump */
+    VERIFY(RingBuf_num_free(&dst) == ARRAY_NELEM(dst_sto) - 1U);
+    RingLz_ctor(&lz, lz_in, lz_out, RING_LZ_MAX_BLOCK + 1U);
+    VERIFY(RING_LZ_MAX_BLOCK == lz.block_len);
+}
+
+TEST("RingLz_read discards the block that does not fit") {
+    uint32_t seed = 5U;
+    for (size_t i = 0U; i < 2U*BLOCK; ++i) { /* two raw blocks */
+        seed = seed * 1664525U + 1013904223U;
+        data[i] = (uint8_t)(seed >> 24);
+    }
+    RingBuf_put_n(&src, data, 2U*BLOCK);
+    VERIFY(BLOCK == RingLz_pump(&lz, &src, &dst, false));
+    VERIFY(BLOCK == RingLz_pump(&lz, &src, &dst, false));
+    VERIFY(RING_LZ_ERROR == RingLz_read(&dst, packed, unpacked, BLOCK - 1U));
+    VERIFY(BLOCK == RingLz_read(&dst, packed, unpacked, BLOCK));
+    VERIFY(0 == memcmp(&data[BLOCK], unpacked, BLOCK));
+    VERIFY(0U == RingLz_read(&dst, packed, unpacked, BLOCK));
+}
+
+PERF_TEST("perf: RingLz_compress() telemetry [bytes]", 100000000U, 0U) {
+    make_telemetry(data, sizeof(data));
+    ET_perf_worker(&compress_worker, &lz, 0);
+    ET_perf_run();
+    size_t const len = RingLz_compress(&lz, data, sizeof(data),
+                                       packed, sizeof(packed));
+    ET_perf_counter_("packed-byte", (100U * len) / sizeof(data));
+}
+
+PERF_TEST("perf: RingLz_decompress() telemetry [bytes]", 100000000U, 0U) {
+    make_telemetry(data, sizeof(data));
+    ET_perf_worker(&decompress_worker, &lz, 0);
+    ET_perf_run();
+}
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+static unsigned long compress_worker(void *arg, unsigned long n_ops) {
+    RingLz * const me = (RingLz *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += sizeof(data)) {
+        RingLz_compress(me, data, sizeof(data), packed, sizeof(packed));
+    }
+    return n;
+}
+static unsigned long decompress_worker(void *arg, unsigned long n_ops) {
+    RingLz * const me = (RingLz *)arg;
+    size_t const len = RingLz_compress(me, data, sizeof(data),
+                                       packed, sizeof(packed));
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += sizeof(data)) {
+        RingLz_decompress(packed, len, unpacked, sizeof(unpacked));
+    }
+    return n;
+}
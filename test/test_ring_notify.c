@@ -0,0 +1,235 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#ifdef Q_HOST
+#define _GNU_SOURCE /* for eventfd(), clock_gettime() */
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_notify.h"
+#include "et.h" /* ET: embedded test */
+
+#ifdef Q_HOST
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#endif
+
+static RingBufElement buf[16];
+static RingBuf rb;
+static RingNotify rn;
+
+/* test notification callback and clock */
+static unsigned n_calls;
+static uint32_t fake_now;
+static void count_notify(void *ctx);
+static uint32_t fake_clock(void);
+
+#ifdef Q_HOST
+static RingBufElement big_buf[1024];
+static RingBuf big_rb;
+static int efd; /* eventfd for blocking the consumer */
+static _Atomic(bool) consumer_done;
+static unsigned long n_wakeups;
+static uint32_t usec_clock(void);
+static void eventfd_notify(void *ctx);
+
+/* performance test workers */
+static unsigned long notify_producer(void *arg, unsigned long n_ops);
+static unsigned long notify_consumer(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("coalesced notification") {
+
+RingBuf_ctor(&rb, buf, ARRAY_NELEM(buf));
+/* notify at 8 elements, re-arm at 2 or less, or after 100 clock units */
+RingNotify_ctor(&rn, &rb, 8U, 2U, 100U, &fake_clock, &count_notify,
+                (void *)0);
+
+TEST("RingNotify high watermark") {
+    fake_now = 0U;
+    n_calls = 0U;
+    for (RingBufElement i = 0U; i < 7U; ++i) {
+        VERIFY(true == RingNotify_put(&rn, i));
+    }
+    VERIFY(0U == n_calls); /* coalesced */
+    VERIFY(true == RingNotify_put(&rn, 7U));
+    VERIFY(1U == n_calls); /* high watermark reached */
+    VERIFY(true == RingNotify_put(&rn, 8U));
+    VERIFY(1U == n_calls); /* disarmed until the consumer re-arms */
+}
+
+TEST("RingNotify low watermark re-arm") {
+    RingBufElement el;
+    for (unsigned i = 0U; i < 6U; ++i) {
+        RingBuf_get(&rb, &el);
+    }
+    VERIFY(false == RingNotify_arm(&rn)); /* 3 > low watermark */
+    RingBuf_get(&rb, &el);
+    VERIFY(true == RingNotify_arm(&rn));  /* 2 == low watermark */
+    for (RingBufElement i = 0U; i < 5U; ++i) {
+        RingNotify_put(&rn, i);
+    }
+    VERIFY(1U == n_calls);
+    RingNotify_put(&rn, 0U);
+    VERIFY(2U == n_calls);
+    while (RingBuf_get(&rb, &el)) {
+    }
+    VERIFY(true == RingNotify_arm(&rn));
+}
+
+TEST("RingNotify coalescing timeout") {
+    n_calls = 0U;
+    fake_now = 1000U;
+    RingNotify_put(&rn, 1U);
+    fake_now = 1050U;
+    RingNotify_put(&rn, 2U);
+    RingNotify_tick(&rn);
+    VERIFY(0U == n_calls);
+    fake_now = 1100U; /* the first element has waited 100 */
+    RingNotify_tick(&rn);
+    VERIFY(1U == n_calls);
+}
+
+TEST("RingNotify no timeout after the consumer drained") {
+    RingBufElement el;
+    while (RingBuf_get(&rb, &el)) {
+    }
+    VERIFY(true == RingNotify_arm(&rn));
+    fake_now += 1000U;
+    RingNotify_tick(&rn);
+    VERIFY(1U == n_calls); /* nothing to notify about */
+}
+
+TEST("RingNotify elements left at re-arm notified after the timeout") {
+    RingBufElement el;
+    n_calls = 0U;
+    fake_now = 3000U;
+    for (RingBufElement i = 0U; i < 8U; ++i) {
+        VERIFY(true == RingNotify_put(&rn, i));
+    }
+    VERIFY(1U == n_calls); /* high watermark */
+    for (unsigned i = 0U; i < 6U; ++i) {
+        VERIFY(true == RingBuf_get(&rb, &el));
+    }
+    VERIFY(true == RingNotify_arm(&rn)); /* 2 left, nothing more put */
+    fake_now = 3050U;
+    RingNotify_tick(&rn);
+    VERIFY(1U == n_calls);
+    fake_now = 3100U; /* 100 since the notification */
+    RingNotify_tick(&rn);
+    VERIFY(2U == n_calls);
+    while (RingBuf_get(&rb, &el)) {
+    }
+    VERIFY(true == RingNotify_arm(&rn));
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: notify on every put, blocking consumer", 200000U, 0U) {
+    RingBuf_ctor(&big_rb, big_buf, ARRAY_NELEM(big_buf));
+    RingNotify_ctor(&rn, &big_rb, 1U, 0U, 0U, &usec_clock,
+                    &eventfd_notify, (void *)0);
+    efd = eventfd(0U, 0);
+    n_wakeups = 0U;
+    ET_perf_worker(&notify_producer, &rn, 0);
+    ET_perf_worker(&notify_consumer, &rn, 1);
+    ET_perf_run();
+    close(efd);
+    ET_perf_counter_("wake", (100U * n_wakeups) / 200000U);
+}
+
+PERF_TEST("perf: coalesced notify (high 256, 50 us)", 200000U, 0U) {
+    RingBuf_ctor(&big_rb, big_buf, ARRAY_NELEM(big_buf));
+    RingNotify_ctor(&rn, &big_rb, 256U, 0U, 50U, &usec_clock,
+                    &eventfd_notify, (void *)0);
+    efd = eventfd(0U, 0);
+    n_wakeups = 0U;
+    ET_perf_worker(&notify_producer, &rn, 0);
+    ET_perf_worker(&notify_consumer, &rn, 1);
+    ET_perf_run();
+    close(efd);
+    ET_perf_counter_("wake", (100U * n_wakeups) / 200000U);
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+static void count_notify(void *ctx) {
+    (void)ctx;
+    ++n_calls;
+}
+static uint32_t fake_clock(void) {
+    return fake_now;
+}
+
+#ifdef Q_HOST
+static uint32_t usec_clock(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000U
+                      + (uint64_t)ts.tv_nsec / 1000U);
+}
+static void eventfd_notify(void *ctx) {
+    (void)ctx;
+    uint64_t const one = 1U;
+    (void)write(efd, &one, sizeof(one));
+}
+
+static unsigned long notify_producer(void *arg, unsigned long n_ops) {
+    RingNotify * const me = (RingNotify *)arg;
+    atomic_store(&consumer_done, false);
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        while (!RingNotify_put(me, (RingBufElement)n)) {
+            RingNotify_tick(me);
+        }
+    }
+    /* the periodic tick (timer), until the consumer has got everything */
+    while (!atomic_load(&consumer_done)) {
+        RingNotify_tick(me);
+        usleep(10U);
+    }
+    return n_ops;
+}
+
+static unsigned long notify_consumer(void *arg, unsigned long n_ops) {
+    RingNotify * const me = (RingNotify *)arg;
+    unsigned long n = 0U;
+    while (n < n_ops) {
+        RingBufElement el;
+        while (RingBuf_get(me->rb, &el)) {
+            VERIFY((RingBufElement)n == el);
+            ++n;
+        }
+        if ((n < n_ops) && RingNotify_arm(me)) {
+            uint64_t cnt;
+            (void)read(efd, &cnt, sizeof(cnt)); /* block */
+            ++n_wakeups;
+        }
+    }
+    atomic_store(&consumer_done, true);
+    return 0U; /* the transfers are counted by the producer */
+}
+#endif /* Q_HOST */
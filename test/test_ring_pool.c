@@ -0,0 +1,150 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buf.h"
+#include "ring_pool.h"
+#include "et.h" /* ET: embedded test */
+
+#define N_BLOCKS 16U
+
+typedef struct {
+    uint32_t sig;
+    uint32_t seq;
+    uint8_t payload[24];
+} Event;
+
+static Event blocks[N_BLOCKS];
+static RingBufElement free_sto[N_BLOCKS + 1U];
+static RingBufElement ev_sto[N_BLOCKS + 1U];
+static RingPool pool;
+
+#ifdef Q_HOST
+#define BIG_BLOCKS 255U /* the most handles of uint8_t RingBufElement */
+static Event big_blocks[BIG_BLOCKS];
+static RingBufElement big_free_sto[BIG_BLOCKS + 1U];
+static RingBufElement big_ev_sto[BIG_BLOCKS + 1U];
+static RingPool big_pool;
+#endif /* Q_HOST */
+
+#ifdef Q_HOST
+/* performance test workers */
+static unsigned long cycle_worker(void *arg, unsigned long n_ops);
+static unsigned long sender_worker(void *arg, unsigned long n_ops);
+static unsigned long receiver_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    RingPool_ctor(&pool, blocks, sizeof(blocks[0]), N_BLOCKS,
+                  free_sto, ev_sto);
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("event ring with memory pool") {
+
+TEST("RingPool_alloc exhausts the pool") {
+    RingBufElement h;
+    bool used[N_BLOCKS] = { false };
+    for (unsigned i = 0U; i < N_BLOCKS; ++i) {
+        VERIFY(true == RingPool_alloc(&pool, &h));
+        VERIFY(h < N_BLOCKS);
+        VERIFY(!used[h]); /* each block only once */
+        used[h] = true;
+        VERIFY((Event *)RingPool_ptr(&pool, h) == &blocks[h]);
+    }
+    VERIFY(false == RingPool_alloc(&pool, &h));
+}
+
+TEST("RingPool_send/recv/free in FIFO order") {
+    RingBufElement h;
+    for (uint32_t i = 0U; i < N_BLOCKS; ++i) {
+        VERIFY(true == RingPool_alloc(&pool, &h));
+        Event * const e = (Event *)RingPool_ptr(&pool, h);
+        e->sig = 5U;
+        e->seq = i;
+        RingPool_send(&pool, h);
+    }
+    for (uint32_t i = 0U; i < N_BLOCKS; ++i) {
+        VERIFY(true == RingPool_recv(&pool, &h));
+        Event const * const e = (Event const *)RingPool_ptr(&pool, h);
+        VERIFY((5U == e->sig) && (i == e->seq));
+        RingPool_free(&pool, h);
+    }
+    VERIFY(false == RingPool_recv(&pool, &h));
+    VERIFY(RingBuf_num_free(&pool.free_list) == 0U); /* all blocks free */
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: RingPool alloc/send/recv/free 1 thread", 10000000U, 0U) {
+    ET_perf_worker(&cycle_worker, &pool, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: RingPool sender/receiver 2 threads", 100000U, 0U) {
+    RingPool_ctor(&big_pool, big_blocks, sizeof(big_blocks[0]), BIG_BLOCKS,
+                  big_free_sto, big_ev_sto);
+    ET_perf_worker(&sender_worker, &big_pool, 0);
+    ET_perf_worker(&receiver_worker, &big_pool, 1);
+    ET_perf_run();
+    VERIFY(RingBuf_num_free(&big_pool.free_list) == 0U); /* none lost */
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+#ifdef Q_HOST
+/*..........................................................................*/
+static unsigned long cycle_worker(void *arg, unsigned long n_ops) {
+    RingPool * const me = (RingPool *)arg;
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        RingBufElement h;
+        RingPool_alloc(me, &h);
+        ((Event *)RingPool_ptr(me, h))->seq = (uint32_t)n;
+        RingPool_send(me, h);
+        RingPool_recv(me, &h);
+        RingPool_free(me, h);
+    }
+    return n_ops;
+}
+static unsigned long sender_worker(void *arg, unsigned long n_ops) {
+    RingPool * const me = (RingPool *)arg;
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        RingBufElement h;
+        while (!RingPool_alloc(me, &h)) {
+        }
+        ((Event *)RingPool_ptr(me, h))->seq = (uint32_t)n;
+        RingPool_send(me, h);
+    }
+    return n_ops;
+}
+static unsigned long receiver_worker(void *arg, unsigned long n_ops) {
+    RingPool * const me = (RingPool *)arg;
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        RingBufElement h;
+        while (!RingPool_recv(me, &h)) {
+        }
+        VERIFY((uint32_t)n == ((Event const *)RingPool_ptr(me, h))->seq);
+        RingPool_free(me, h);
+    }
+    return 0U; /* the transfers are counted by the sender */
+}
+#endif /* Q_HOST */
@@ -0,0 +1,236 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "ring_set.h"
+#include "et.h" /* ET: embedded test */
+
+#define N_RINGS 8U
+
+static RingBufElement bufs[RING_SET_MAX][16];
+static RingBuf rbs[RING_SET_MAX];
+static RingSet rs;
+
+/* ring-set "handler" function for RingSet_process_all() */
+static void rs_handler(uint8_t const idx, RingBufElement const el);
+
+static uint8_t  test_idx[8];
+static uint8_t  test_el[8];
+static unsigned test_n;
+
+#ifdef Q_HOST
+#define N_PROD 4U
+
+/* performance test workers */
+static unsigned long set_put_get_worker(void *arg, unsigned long n_ops);
+static unsigned long scan_put_get_worker(void *arg, unsigned long n_ops);
+static unsigned long set_producer_worker(void *arg, unsigned long n_ops);
+static unsigned long set_consumer_worker(void *arg, unsigned long n_ops);
+static unsigned long n_errors;
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("ring set") {
+
+RingSet_ctor(&rs);
+for (unsigned i = 0U; i < N_RINGS; ++i) {
+    RingBuf_ctor(&rbs[i], bufs[i], ARRAY_NELEM(bufs[i]));
+    RingSet_add(&rs, &rbs[i]);
+}
+
+TEST("RingSet_get empty") {
+    uint8_t idx;
+    RingBufElement el;
+    VERIFY(false == RingSet_get(&rs, &idx, &el));
+    VERIFY(0U == atomic_load(&rs.ready));
+}
+
+TEST("RingSet_put marks the ring ready") {
+    VERIFY(true == RingSet_put(&rs, 3U, 0xAAU));
+    VERIFY(true == RingSet_put(&rs, 7U, 0xBBU));
+    VERIFY(true == RingSet_put(&rs, 7U, 0xCCU));
+    VERIFY(((1U << 3) | (1U << 7)) == atomic_load(&rs.ready));
+}
+
+TEST("RingSet_get round-robin") {
+    uint8_t idx;
+    RingBufElement el;
+    VERIFY(true == RingSet_get(&rs, &idx, &el));
+    VERIFY((3U == idx) && (0xAAU == el));
+    VERIFY(true == RingSet_get(&rs, &idx, &el));
+    VERIFY((7U == idx) && (0xBBU == el));
+    VERIFY(true == RingSet_get(&rs, &idx, &el));
+    VERIFY((7U == idx) && (0xCCU == el));
+    VERIFY(false == RingSet_get(&rs, &idx, &el));
+    VERIFY(0U == atomic_load(&rs.ready)); /* bits of empty rings cleared */
+}
+
+TEST("RingSet_get fairness") {
+    uint8_t idx;
+    RingBufElement el;
+    for (RingBufElement i = 0U; i < 3U; ++i) {
+        RingSet_put(&rs, 0U, i);
+        RingSet_put(&rs, 5U, i);
+    }
+    /* the busy ring 0 must not starve ring 5 */
+    for (RingBufElement i = 0U; i < 3U; ++i) {
+        VERIFY(true == RingSet_get(&rs, &idx, &el));
+        VERIFY((0U == idx) && (i == el));
+        VERIFY(true == RingSet_get(&rs, &idx, &el));
+        VERIFY((5U == idx) && (i == el));
+    }
+    VERIFY(false == RingSet_get(&rs, &idx, &el));
+}
+
+TEST("RingSet_process_all") {
+    RingSet_put(&rs, 6U, 0xA6U);
+    RingSet_put(&rs, 1U, 0xA1U);
+    RingSet_put(&rs, 4U, 0xA4U);
+    test_n = 0U;
+    RingSet_process_all(&rs, &rs_handler);
+    VERIFY(3U == test_n);
+    /* round-robin continues after the last serviced ring 5 */
+    VERIFY((6U == test_idx[0]) && (0xA6U == test_el[0]));
+    VERIFY((1U == test_idx[1]) && (0xA1U == test_el[1]));
+    VERIFY((4U == test_idx[2]) && (0xA4U == test_el[2]));
+    VERIFY(0U == atomic_load(&rs.ready));
+}
+
+TEST("RingSet_add full set") {
+    RingSet_ctor(&rs);
+    for (unsigned i = 0U; i < RING_SET_MAX; ++i) {
+        VERIFY(i == RingSet_add(&rs, &rbs[i]));
+    }
+    VERIFY(RING_SET_MAX == RingSet_add(&rs, &rbs[0]));
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: RingSet_put/get, 1 of 32 rings active", 10000000U, 0U) {
+    for (unsigned i = 0U; i < RING_SET_MAX; ++i) {
+        RingBuf_ctor(&rbs[i], bufs[i], ARRAY_NELEM(bufs[i]));
+    }
+    ET_perf_worker(&set_put_get_worker, &rs, 0);
+    ET_perf_run();
+    /* the bit of the emptied ring is cleared lazily, by the next get */
+    uint8_t idx;
+    RingBufElement el;
+    VERIFY(false == RingSet_get(&rs, &idx, &el));
+    VERIFY(0U == atomic_load(&rs.ready));
+}
+
+PERF_TEST("perf: scan of 32 RingBufs, 1 active", 10000000U, 0U) {
+    ET_perf_worker(&scan_put_get_worker, rbs, 0);
+    ET_perf_run();
+    VERIFY(RingBuf_num_free(&rbs[RING_SET_MAX - 1U])
+           == ARRAY_NELEM(bufs[0]) - 1U);
+}
+
+PERF_TEST("perf: RingSet 4 producers, blocking consumer", 20000U, 0U) {
+    RingSet_ctor(&rs);
+    for (unsigned i = 0U; i < N_PROD; ++i) {
+        RingBuf_ctor(&rbs[i], bufs[i], ARRAY_NELEM(bufs[i]));
+        RingSet_add(&rs, &rbs[i]);
+    }
+    n_errors = 0U;
+    ET_perf_worker(&set_consumer_worker, &rs, 0);
+    for (unsigned i = 0U; i < N_PROD; ++i) {
+        ET_perf_worker(&set_producer_worker, &rbs[i], (int)i + 1);
+    }
+    ET_perf_run();
+    VERIFY(0U == n_errors);
+    uint8_t idx;
+    RingBufElement el;
+    VERIFY(false == RingSet_get(&rs, &idx, &el)); /* all elements consumed */
+    VERIFY(0U == atomic_load(&rs.ready));
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+static void rs_handler(uint8_t const idx, RingBufElement const el) {
+    VERIFY(test_n < ARRAY_NELEM(test_idx));
+    test_idx[test_n] = idx;
+    test_el[test_n]  = el;
+    ++test_n;
+}
+
+#ifdef Q_HOST
+static unsigned long set_put_get_worker(void *arg, unsigned long n_ops) {
+    RingSet * const me = (RingSet *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += 2U) {
+        uint8_t idx;
+        RingBufElement el;
+        RingSet_put(me, RING_SET_MAX - 1U, (RingBufElement)n);
+        RingSet_get(me, &idx, &el);
+    }
+    return n;
+}
+
+/* the alternative to RingSet: polling every ring in the set */
+static unsigned long scan_put_get_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const rings = (RingBuf *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += 2U) {
+        RingBufElement el;
+        RingBuf_put(&rings[RING_SET_MAX - 1U], (RingBufElement)n);
+        for (unsigned i = 0U; i < RING_SET_MAX; ++i) {
+            if (RingBuf_get(&rings[i], &el)) {
+                break;
+            }
+        }
+    }
+    return n;
+}
+
+static unsigned long set_producer_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const rb = (RingBuf *)arg;
+    uint8_t const idx = (uint8_t)(rb - rbs);
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        while (!RingSet_put(&rs, idx, (RingBufElement)n)) {
+        }
+    }
+    return n_ops;
+}
+
+static unsigned long set_consumer_worker(void *arg, unsigned long n_ops) {
+    RingSet * const me = (RingSet *)arg;
+    RingBufElement expected[N_PROD] = { 0U };
+    for (unsigned long n = 0U; n < N_PROD * n_ops; ++n) {
+        uint8_t idx;
+        RingBufElement el;
+        while (!RingSet_get(me, &idx, &el)) {
+            RingSet_wait(me);
+        }
+        if ((idx >= N_PROD) || (expected[idx] != el)) {
+            ++n_errors;
+        }
+        else {
+            ++expected[idx];
+        }
+    }
+    return 0U; /* the transfers are counted by the producers */
+}
+#endif /* Q_HOST */
@@ -0,0 +1,165 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buf.h"
+#include "ring_share.h"
+#include "et.h" /* ET: embedded test */
+
+#define N_CONS 4U
+
+static uint8_t arena[4096];
+static RingDesc descs[16];
+static RingShare rs;
+
+static RingBufElement cons_sto[N_CONS][8];
+static RingBuf cons_rb[N_CONS];
+static RingBuf *cons[N_CONS];
+
+static uint8_t payload[1024];
+static uint8_t copies_sto[N_CONS][8 * 1024];
+static uint8_t sink[1024];
+
+/* performance test workers */
+static unsigned long share_worker(void *arg, unsigned long n_ops);
+static unsigned long copy_worker(void *arg, unsigned long n_ops);
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    RingShare_ctor(&rs, arena, sizeof(arena), descs, ARRAY_NELEM(descs));
+    for (unsigned i = 0U; i < N_CONS; ++i) {
+        RingBuf_ctor(&cons_rb[i], cons_sto[i], ARRAY_NELEM(cons_sto[i]));
+        cons[i] = &cons_rb[i];
+    }
+    for (unsigned i = 0U; i < sizeof(payload); ++i) {
+        payload[i] = (uint8_t)i;
+    }
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("reference-counted shared buffers") {
+
+TEST("RingShare_publish to all consumers (zero-copy)") {
+    RingBufElement h;
+    VERIFY(true == RingShare_alloc(&rs, 1000U, &h));
+    memcpy(RingShare_ptr(&rs, h), payload, 1000U);
+    VERIFY(N_CONS == RingShare_publish(&rs, h, cons, N_CONS));
+    VERIFY(N_CONS == atomic_load(&descs[h].refs));
+    for (unsigned i = 0U; i < N_CONS; ++i) {
+        RingBufElement hc;
+        VERIFY(true == RingBuf_get(cons[i], &hc));
+        VERIFY(h == hc);
+        VERIFY(1000U == RingShare_len(&rs, hc));
+        VERIFY(0 == memcmp(RingShare_ptr(&rs, hc), payload, 1000U));
+        RingShare_release(&rs, hc);
+    }
+    VERIFY(0U == atomic_load(&descs[h].refs));
+}
+
+TEST("RingShare_alloc reclaims only the released slices") {
+    RingBufElement h[4];
+    for (unsigned k = 0U; k < 4U; ++k) { /* fill the whole arena */
+        VERIFY(true == RingShare_alloc(&rs, 1024U, &h[k]));
+        VERIFY(N_CONS == RingShare_publish(&rs, h[k], cons, N_CONS));
+    }
+    VERIFY(false == RingShare_alloc(&rs, 1U, &h[0]));
+
+    /* consumers 0..2 release all, consumer 3 releases only the 2nd */
+    for (unsigned i = 0U; i < N_CONS; ++i) {
+        for (unsigned k = 0U; k < 4U; ++k) {
+            RingBufElement hc;
+            VERIFY(true == RingBuf_get(cons[i], &hc));
+            if ((i != 3U) || (k == 1U)) {
+                RingShare_release(&rs, hc);
+            }
+        }
+    }
+    /* the 1st slice is still held, so the released 2nd cannot be reused */
+    RingBufElement hn;
+    VERIFY(false == RingShare_alloc(&rs, 1U, &hn));
+    RingShare_release(&rs, h[0]); /* consumer 3 releases the 1st */
+    VERIFY(true == RingShare_alloc(&rs, 2048U, &hn)); /* 1st and 2nd */
+    VERIFY(RingShare_ptr(&rs, hn) == &arena[0]);
+    VERIFY(false == RingShare_alloc(&rs, 1U, &hn));
+}
+
+TEST("RingShare_publish skips full rings") {
+    RingBufElement h;
+    for (unsigned k = 0U; k < ARRAY_NELEM(cons_sto[0]) - 1U; ++k) {
+        RingBuf_put(cons[2], 0U); /* consumer 2 stalls */
+    }
+    VERIFY(true == RingShare_alloc(&rs, 10U, &h));
+    VERIFY(N_CONS - 1U == RingShare_publish(&rs, h, cons, N_CONS));
+    VERIFY(N_CONS - 1U == atomic_load(&descs[h].refs));
+}
+
+PERF_TEST("perf: RingShare 1KB payload to 4 consumers", 1000000U, 0U) {
+    ET_perf_worker(&share_worker, &rs, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: copy 1KB payload into 4 consumer rings", 1000000U, 0U) {
+    ET_perf_worker(&copy_worker, (void *)0, 0);
+    ET_perf_run();
+}
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+/* publish + all consumers read the first and last byte and release */
+static unsigned long share_worker(void *arg, unsigned long n_ops) {
+    RingShare * const me = (RingShare *)arg;
+    unsigned sum = 0U;
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        RingBufElement h;
+        RingShare_alloc(me, sizeof(payload), &h);
+        memcpy(RingShare_ptr(me, h), payload, sizeof(payload));
+        RingShare_publish(me, h, cons, N_CONS);
+        for (unsigned i = 0U; i < N_CONS; ++i) {
+            RingBuf_get(cons[i], &h);
+            uint8_t const *p = RingShare_ptr(me, h);
+            sum += p[0] + p[RingShare_len(me, h) - 1U];
+            RingShare_release(me, h);
+        }
+    }
+    sink[0] = (uint8_t)sum;
+    return n_ops;
+}
+/* the same payload copied into the byte ring of each consumer */
+static unsigned long copy_worker(void *arg, unsigned long n_ops) {
+    (void)arg;
+    static RingBuf rb[N_CONS];
+    for (unsigned i = 0U; i < N_CONS; ++i) {
+        RingBuf_ctor(&rb[i], copies_sto[i], sizeof(copies_sto[i]));
+    }
+    unsigned sum = 0U;
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        for (unsigned i = 0U; i < N_CONS; ++i) {
+            RingBuf_put_n(&rb[i], payload, sizeof(payload));
+        }
+        for (unsigned i = 0U; i < N_CONS; ++i) {
+            RingBuf_get_n(&rb[i], sink, sizeof(sink));
+            sum += sink[0] + sink[sizeof(sink) - 1U];
+        }
+    }
+    sink[0] = (uint8_t)sum;
+    return n_ops;
+}
@@ -0,0 +1,185 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "ring_buf.h"
+#include "ring_span.h"
+#include "et.h" /* ET: embedded test */
+
+static RingBufElement sto[200];
+static RingBuf rb;
+static uint8_t buf[256];
+static uint32_t rnd = 12345U;
+
+/* performance test workers */
+static unsigned long get_until_worker(void *arg, unsigned long n_ops);
+static unsigned long get_loop_worker(void *arg, unsigned long n_ops);
+
+/* simple pseudo-random generator (LCG) */
+static uint8_t rnd_byte(void) {
+    rnd = rnd * 1664525U + 1013904223U;
+    return (uint8_t)(rnd >> 24);
+}
+/* move the empty ring buffer to the given position (wrap-around tests) */
+static void rewind_to(RingBufCtr const pos) {
+    atomic_store(&rb.head, pos);
+    atomic_store(&rb.tail, pos);
+}
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    RingBuf_ctor(&rb, sto, ARRAY_NELEM(sto));
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("ring buffer spans") {
+
+TEST("RingBuf_find/count in empty buffer") {
+    VERIFY(RING_BUF_NOT_FOUND == RingBuf_find(&rb, 0U));
+    VERIFY(0U == RingBuf_count(&rb, 0U));
+}
+
+TEST("RingBuf_find/count against byte-by-byte reference") {
+    for (RingBufCtr pos = 0U; pos < ARRAY_NELEM(sto); pos += 7U) {
+        for (RingBufCtr n = 0U; n < ARRAY_NELEM(sto); n += 13U) {
+            rewind_to(pos);
+            for (RingBufCtr i = 0U; i < n; ++i) {
+                buf[i] = rnd_byte() & 0x3FU; /* frequent matches */
+                RingBuf_put(&rb, buf[i]);
+            }
+            uint8_t const c = rnd_byte() & 0x3FU;
+            RingBufCtr ref_pos = RING_BUF_NOT_FOUND;
+            RingBufCtr ref_cnt = 0U;
+            for (RingBufCtr i = 0U; i < n; ++i) {
+                if (buf[i] == c) {
+                    ++ref_cnt;
+                    if (ref_pos == RING_BUF_NOT_FOUND) {
+                        ref_pos = i;
+                    }
+                }
+            }
+            VERIFY(ref_pos == RingBuf_find(&rb, c));
+            VERIFY(ref_cnt == RingBuf_count(&rb, c));
+            VERIFY(RING_BUF_NOT_FOUND == RingBuf_find(&rb, 0xFFU));
+        }
+    }
+}
+
+TEST("RingBuf_get_until wrap-around") {
+    rewind_to(ARRAY_NELEM(sto) - 40U);
+    static char const msg[] = "first line of text\nsecond line, wrapped\n";
+    RingBufCtr const len = sizeof(msg) - 1U;
+    VERIFY(len == RingBuf_put_n(&rb, (uint8_t const *)msg, len));
+
+    VERIFY(19U == RingBuf_get_until(&rb, '\n', buf, sizeof(buf)));
+    VERIFY(0 == memcmp(buf, "first line of text\n", 19U));
+    VERIFY(RING_BUF_NOT_FOUND
+           == RingBuf_get_until(&rb, '\n', buf, 5U)); /* too short */
+    VERIFY(len - 19U == RingBuf_get_until(&rb, '\n', buf, sizeof(buf)));
+    VERIFY(0 == memcmp(buf, "second line, wrapped\n", len - 19U));
+    VERIFY(0U == RingBuf_get_until(&rb, '\n', buf, sizeof(buf)));
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(sto) - 1U);
+}
+
+TEST("RingBuf_get_until incomplete frame is not removed") {
+    RingBuf_put_n(&rb, (uint8_t const *)"\x7E" "abc", 4U);
+    VERIFY(1U == RingBuf_get_until(&rb, 0x7EU, buf, sizeof(buf)));
+    VERIFY(0U == RingBuf_get_until(&rb, 0x7EU, buf, sizeof(buf)));
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(sto) - 1U - 3U);
+    RingBuf_put(&rb, 0x7EU);
+    VERIFY(4U == RingBuf_get_until(&rb, 0x7EU, buf, sizeof(buf)));
+    VERIFY(0 == memcmp(buf, "abc\x7E", 4U));
+}
+
+TEST("RingBuf_get_until reports a frame that cannot complete") {
+    RingBuf_put_n(&rb, (uint8_t const *)"abcdef", 6U);
+    VERIFY(0U == RingBuf_get_until(&rb, '\n', buf, sizeof(buf)));
+    VERIFY(RING_BUF_NOT_FOUND == RingBuf_get_until(&rb, '\n', buf, 6U));
+    VERIFY(RingBuf_num_free(&rb) == ARRAY_NELEM(sto) - 1U - 6U);
+    /* fill up the ring buffer without the delimiter */
+    memset(buf, 'x', sizeof(buf));
+    RingBufCtr const n_free = RingBuf_num_free(&rb);
+    VERIFY(n_free == RingBuf_put_n(&rb, buf, n_free));
+    VERIFY(RING_BUF_NOT_FOUND
+           == RingBuf_get_until(&rb, '\n', buf, sizeof(buf)));
+    VERIFY(6U == RingBuf_get_n(&rb, buf, 6U)); /* drain and resync */
+    RingBuf_put(&rb, '\n');
+    VERIFY(ARRAY_NELEM(sto) - 6U
+           == RingBuf_get_until(&rb, '\n', buf, sizeof(buf)));
+}
+
+PERF_TEST("perf: RingBuf_get_until() 64-byte lines [bytes]",
+          10000000U, 0U)
+{
+    ET_perf_worker(&get_until_worker, &rb, 0);
+    ET_perf_run();
+}
+
+PERF_TEST("perf: RingBuf_get() loop 64-byte lines [bytes]",
+          10000000U, 0U)
+{
+    ET_perf_worker(&get_loop_worker, &rb, 0);
+    ET_perf_run();
+}
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+/* put 3 lines of 64 bytes (the storage of 200 bytes wraps around) */
+static void put_lines(RingBuf * const me) {
+    static uint8_t line[64];
+    if (line[63] != '\n') {
+        memset(line, 'x', sizeof(line) - 1U);
+        line[63] = '\n';
+    }
+    for (unsigned i = 0U; i < 3U; ++i) {
+        RingBuf_put_n(me, line, sizeof(line));
+    }
+}
+static unsigned long get_until_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    unsigned long n = 0U;
+    while (n < n_ops) {
+        put_lines(me);
+        RingBufCtr k;
+        while ((k = RingBuf_get_until(me, '\n', buf, sizeof(buf))) != 0U) {
+            n += k;
+        }
+    }
+    return n;
+}
+static unsigned long get_loop_worker(void *arg, unsigned long n_ops) {
+    RingBuf * const me = (RingBuf *)arg;
+    unsigned long n = 0U;
+    while (n < n_ops) {
+        put_lines(me);
+        RingBufCtr k = 0U;
+        RingBufElement el;
+        while (RingBuf_get(me, &el)) {
+            buf[k++] = el;
+            if (el == '\n') {
+                n += k;
+                k = 0U;
+            }
+        }
+    }
+    return n;
+}
@@ -0,0 +1,143 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#define _GNU_SOURCE /* for getpid(), unlink() */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include "ring_buf.h"
+#include "ring_spill.h"
+#include "et.h" /* ET: embedded test */
+
+static RingBufElement mem_sto[8];
+static RingBuf mem;
+static RingSpill rs;
+static char path[64];
+
+/* performance test worker */
+static unsigned long burst_worker(void *arg, unsigned long n_ops);
+
+void setup(void) {
+    snprintf(path, sizeof(path), "/tmp/test_ring_spill_%d.bin",
+             (int)getpid());
+    (void)unlink(path);
+    RingBuf_ctor(&mem, mem_sto, ARRAY_NELEM(mem_sto));
+    RingSpill_ctor(&rs, &mem, path, 1000U);
+}
+
+void teardown(void) {
+    RingSpill_xtor(&rs);
+    (void)unlink(path);
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("ring buffer with spill file") {
+
+TEST("RingSpill_ctor") {
+    VERIFY(rs.spill != (RingBufPersist *)0);
+    VERIFY(0U == RingSpill_num_spilled(&rs));
+    RingBufElement el;
+    VERIFY(false == RingSpill_get(&rs, &el));
+}
+
+TEST("RingSpill_put overflows into the spill in FIFO order") {
+    for (RingBufElement i = 0U; i < 20U; ++i) {
+        VERIFY(true == RingSpill_put(&rs, i));
+    }
+    VERIFY(RingBuf_num_free(&mem) == 0U);
+    VERIFY(20U - (ARRAY_NELEM(mem_sto) - 1U) == RingSpill_num_spilled(&rs));
+    VERIFY(rs.n_spilled == RingSpill_num_spilled(&rs));
+    for (RingBufElement i = 0U; i < 20U; ++i) {
+        RingBufElement el;
+        VERIFY(true == RingSpill_get(&rs, &el));
+        VERIFY(i == el);
+    }
+    RingBufElement el;
+    VERIFY(false == RingSpill_get(&rs, &el));
+    VERIFY(0U == rs.n_drops);
+}
+
+TEST("RingSpill_put keeps spilling until the spill is drained") {
+    RingBufElement n_in  = 0U;
+    RingBufElement n_out = 0U;
+    RingBufElement el;
+    for (unsigned k = 0U; k < 50U; ++k) { /* alternating bursts */
+        for (unsigned i = 0U; i < (k % 7U) * 3U; ++i) {
+            VERIFY(true == RingSpill_put(&rs, n_in++));
+        }
+        for (unsigned i = 0U; i < (k % 5U) * 3U; ++i) {
+            if (RingSpill_get(&rs, &el)) {
+                VERIFY(n_out++ == el);
+            }
+        }
+    }
+    while (RingSpill_get(&rs, &el)) {
+        VERIFY(n_out++ == el);
+    }
+    VERIFY(n_in == n_out);
+    VERIFY(0U < rs.n_spilled);
+    /* after the spill is drained, the elements go to 'mem' again */
+    VERIFY(true == RingSpill_put(&rs, 0xABU));
+    VERIFY(RingBuf_num_free(&mem) == ARRAY_NELEM(mem_sto) - 2U);
+}
+
+TEST("RingSpill_put drops when both the ring and spill are full") {
+    unsigned n = 0U;
+    while (RingSpill_put(&rs, (RingBufElement)n)) {
+        ++n;
+    }
+    VERIFY((ARRAY_NELEM(mem_sto) - 1U) + (1000U - 1U) == n);
+    VERIFY(1U == rs.n_drops);
+}
+
+TEST("RingSpill spilled elements survive the restart") {
+    for (RingBufElement i = 0U; i < 10U; ++i) {
+        RingSpill_put(&rs, i);
+    }
+    RingSpill_xtor(&rs);
+    RingBuf_ctor(&mem, mem_sto, ARRAY_NELEM(mem_sto)); /* RAM is lost */
+    VERIFY(true == RingSpill_ctor(&rs, &mem, path, 1000U));
+    VERIFY(10U - (ARRAY_NELEM(mem_sto) - 1U) == RingSpill_num_spilled(&rs));
+    RingBufElement el;
+    for (RingBufElement i = ARRAY_NELEM(mem_sto) - 1U; i < 10U; ++i) {
+        VERIFY(true == RingSpill_get(&rs, &el));
+        VERIFY(i == el);
+    }
+    VERIFY(false == RingSpill_get(&rs, &el));
+}
+
+PERF_TEST("perf: RingSpill bursts 100x the ring length", 10000000U, 0U) {
+    ET_perf_worker(&burst_worker, &rs, 0);
+    ET_perf_run();
+}
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+static unsigned long burst_worker(void *arg, unsigned long n_ops) {
+    RingSpill * const me = (RingSpill *)arg;
+    unsigned long n;
+    for (n = 0U; n < n_ops; n += 1600U) { /* put + get of 800 elements */
+        RingBufElement el;
+        for (unsigned i = 0U; i < 800U; ++i) {
+            RingSpill_put(me, (RingBufElement)i);
+        }
+        while (RingSpill_get(me, &el)) {
+        }
+    }
+    return n;
+}
@@ -0,0 +1,151 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <cstdint>
+#include <memory>
+
+#include "spsc_ring.hpp"
+#include "et.h" /* ET: embedded test */
+
+/* element type that counts its live instances */
+struct Counted {
+    static int live;
+    int val;
+    explicit Counted(int v) : val(v) { ++live; }
+    Counted(Counted &&other) noexcept : val(other.val) { ++live; }
+    Counted &operator=(Counted &&other) noexcept {
+        val = other.val;
+        return *this;
+    }
+    ~Counted() { --live; }
+};
+int Counted::live;
+
+static lfrb::SpscRing<std::unique_ptr<int>, 4> ring;
+
+#ifdef Q_HOST
+static lfrb::SpscRing<std::unique_ptr<int>, 0x10000U> big_ring;
+
+/* performance test workers */
+static unsigned long producer_worker(void *arg, unsigned long n_ops);
+static unsigned long consumer_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("C++ SpscRing") {
+
+TEST("SpscRing capacity") {
+    VERIFY(ring.capacity() == 4U);
+    VERIFY(ring.num_free() == 4U);
+    VERIFY(ring.empty());
+}
+
+TEST("SpscRing emplace/try_pop move-only") {
+    VERIFY(ring.emplace(new int(1)));
+    VERIFY(ring.try_push(std::make_unique<int>(2)));
+    VERIFY(ring.num_free() == 2U);
+
+    std::unique_ptr<int> p;
+    VERIFY(ring.try_pop(p));
+    VERIFY((p != nullptr) && (*p == 1));
+    std::optional<std::unique_ptr<int>> q = ring.try_pop();
+    VERIFY(q.has_value() && (**q == 2));
+    VERIFY(!ring.try_pop().has_value());
+    VERIFY(ring.num_free() == 4U);
+}
+
+TEST("SpscRing full and wrap-around") {
+    for (int i = 0; i < 10; ++i) {
+        for (int k = 0; k < 4; ++k) {
+            VERIFY(ring.emplace(std::make_unique<int>(i + k)));
+        }
+        VERIFY(!ring.emplace(std::make_unique<int>(-1))); /* full */
+        VERIFY(ring.num_free() == 0U);
+        for (int k = 0; k < 4; ++k) {
+            std::unique_ptr<int> p;
+            VERIFY(ring.try_pop(p) && (*p == i + k));
+        }
+    }
+}
+
+TEST("SpscRing consume_all lambda") {
+    for (int k = 0; k < 3; ++k) {
+        VERIFY(ring.emplace(std::make_unique<int>(10 + k)));
+    }
+    int expected = 10;
+    std::size_t n = ring.consume_all([&expected](std::unique_ptr<int> &&p) {
+        VERIFY(*p == expected);
+        ++expected;
+    });
+    VERIFY(n == 3U);
+    VERIFY(ring.empty());
+}
+
+TEST("SpscRing destroys remaining elements") {
+    {
+        lfrb::SpscRing<Counted, 8> r;
+        VERIFY(r.emplace(1));
+        VERIFY(r.emplace(2));
+        VERIFY(r.emplace(3));
+        Counted c(0);
+        VERIFY(r.try_pop(c) && (c.val == 1));
+        VERIFY(Counted::live == 3); /* 2 in the ring + c */
+    }
+    VERIFY(Counted::live == 0);
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: SpscRing<unique_ptr> producer/consumer 2 threads",
+          200000U, 0U)
+{
+    ET_perf_worker(&producer_worker, &big_ring, 0);
+    ET_perf_worker(&consumer_worker, &big_ring, 1);
+    ET_perf_run();
+    VERIFY(big_ring.empty());
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+#ifdef Q_HOST
+static unsigned long producer_worker(void *arg, unsigned long n_ops) {
+    auto * const r = static_cast<decltype(big_ring) *>(arg);
+    for (unsigned long n = 0U; n < n_ops; ++n) {
+        auto p = std::make_unique<int>(static_cast<int>(n));
+        while (!r->try_push(std::move(p))) {
+        }
+    }
+    return n_ops;
+}
+
+static unsigned long consumer_worker(void *arg, unsigned long n_ops) {
+    auto * const r = static_cast<decltype(big_ring) *>(arg);
+    unsigned long n = 0U;
+    while (n < n_ops) {
+        r->consume_all([&n](std::unique_ptr<int> &&p) {
+            VERIFY(*p == static_cast<int>(n));
+            ++n;
+        });
+    }
+    return 0U; /* the transfers are counted by the producer */
+}
+#endif /* Q_HOST */
@@ -0,0 +1,240 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <coroutine>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include "spsc_ring_co.hpp"
+#include "et.h" /* ET: embedded test */
+
+/* minimal fire-and-forget coroutine type for the tests */
+struct Task {
+    struct promise_type {
+        Task get_return_object() noexcept { return Task{}; }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {}
+    };
+};
+
+static lfrb::AsyncSpscRing<std::unique_ptr<int>, 4> ring;
+static int last_popped;
+static int n_popped;
+static int n_pushed;
+
+static Task consumer_co(lfrb::AsyncSpscRing<std::unique_ptr<int>, 4> &r,
+                        int n)
+{
+    for (int i = 0; i < n; ++i) {
+        std::unique_ptr<int> p = co_await r.pop();
+        last_popped = *p;
+        ++n_popped;
+    }
+}
+
+static Task producer_co(lfrb::AsyncSpscRing<std::unique_ptr<int>, 4> &r,
+                        int first, int n)
+{
+    for (int i = 0; i < n; ++i) {
+        co_await r.push(std::make_unique<int>(first + i));
+        ++n_pushed;
+    }
+}
+
+#ifdef Q_HOST
+/* bounded queue with a mutex and condition variables for comparison */
+template<typename T, std::size_t N>
+class CvQueue {
+public:
+    void push(T el) {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_full.wait(lock, [this]() { return m_count < N; });
+        m_buf[(m_first + m_count) % N] = std::move(el);
+        ++m_count;
+        m_not_empty.notify_one();
+    }
+    T pop() {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_not_empty.wait(lock, [this]() { return m_count != 0U; });
+        T el = std::move(m_buf[m_first]);
+        m_first = (m_first + 1U) % N;
+        --m_count;
+        m_not_full.notify_one();
+        return el;
+    }
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+    T m_buf[N];
+    std::size_t m_first = 0U;
+    std::size_t m_count = 0U;
+};
+
+static lfrb::AsyncSpscRing<std::uint32_t, 1024> perf_ring;
+static CvQueue<std::uint32_t, 1024> cv_queue;
+
+/* performance test workers */
+static unsigned long co_worker(void *arg, unsigned long n_ops);
+static unsigned long co_consumer_worker(void *arg, unsigned long n_ops);
+static unsigned long co_producer_worker(void *arg, unsigned long n_ops);
+static unsigned long cv_producer_worker(void *arg, unsigned long n_ops);
+static unsigned long cv_consumer_worker(void *arg, unsigned long n_ops);
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+    n_popped = 0;
+    n_pushed = 0;
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("C++20 AsyncSpscRing") {
+
+TEST("pop suspends on empty, resumed by try_push") {
+    consumer_co(ring, 2); /* suspends right away (empty) */
+    VERIFY(n_popped == 0);
+    VERIFY(ring.try_push(std::make_unique<int>(7)));
+    VERIFY((n_popped == 1) && (last_popped == 7)); /* resumed & suspended */
+    VERIFY(ring.try_push(std::make_unique<int>(8)));
+    VERIFY((n_popped == 2) && (last_popped == 8)); /* finished */
+    VERIFY(ring.num_free() == 4U);
+}
+
+TEST("push suspends on full, resumed by try_pop") {
+    producer_co(ring, 100, 6); /* 4 fit, then suspends */
+    VERIFY(n_pushed == 4);
+    VERIFY(ring.num_free() == 0U);
+    std::optional<std::unique_ptr<int>> p = ring.try_pop();
+    VERIFY(p.has_value() && (**p == 100));
+    VERIFY(n_pushed == 5); /* resumed, pushed, suspended again */
+    p = ring.try_pop();
+    VERIFY(p.has_value() && (**p == 101));
+    VERIFY(n_pushed == 6); /* finished */
+    for (int i = 102; i < 106; ++i) {
+        p = ring.try_pop();
+        VERIFY(p.has_value() && (**p == i));
+    }
+    VERIFY(!ring.try_pop().has_value());
+}
+
+TEST("producer and consumer coroutines") {
+    consumer_co(ring, 100);
+    producer_co(ring, 0, 100);
+    VERIFY((n_pushed == 100) && (n_popped == 100) && (last_popped == 99));
+    VERIFY(ring.num_free() == 4U);
+}
+
+#ifdef Q_HOST
+PERF_TEST("perf: coroutines, 1 thread", 2000000U, 0U) {
+    ET_perf_worker(&co_worker, &perf_ring, 0);
+    ET_perf_run();
+    VERIFY(perf_ring.num_free() == perf_ring.capacity());
+}
+
+PERF_TEST("perf: coroutine consumer resumed by producer thread",
+          2000000U, 0U)
+{
+    ET_perf_worker(&co_consumer_worker, &perf_ring, 1);
+    ET_perf_worker(&co_producer_worker, &perf_ring, 0);
+    ET_perf_run();
+    VERIFY(perf_ring.num_free() == perf_ring.capacity());
+}
+
+PERF_TEST("perf: mutex/condition-variable queue, 2 threads",
+          2000000U, 0U)
+{
+    ET_perf_worker(&cv_consumer_worker, &cv_queue, 1);
+    ET_perf_worker(&cv_producer_worker, &cv_queue, 0);
+    ET_perf_run();
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+#ifdef Q_HOST
+static std::uint32_t perf_expected;
+static std::atomic<unsigned long> perf_consumed;
+
+static Task perf_consumer_co(lfrb::AsyncSpscRing<std::uint32_t, 1024> &r,
+                             unsigned long n)
+{
+    for (unsigned long i = 0U; i < n; ++i) {
+        std::uint32_t el = co_await r.pop();
+        VERIFY(el == perf_expected);
+        ++perf_expected;
+    }
+    perf_consumed.store(n, std::memory_order_release);
+}
+
+static Task perf_producer_co(lfrb::AsyncSpscRing<std::uint32_t, 1024> &r,
+                             unsigned long n)
+{
+    for (unsigned long i = 0U; i < n; ++i) {
+        co_await r.push(static_cast<std::uint32_t>(i));
+    }
+}
+
+/* both coroutines driven from one thread (ops: transfers) */
+static unsigned long co_worker(void *arg, unsigned long n_ops) {
+    auto &r = *static_cast<decltype(perf_ring) *>(arg);
+    perf_expected = 0U;
+    perf_consumer_co(r, n_ops);
+    perf_producer_co(r, n_ops);
+    return n_ops;
+}
+
+/* consumer coroutine started in one thread and then resumed by the
+* producer thread (ops: transfers) */
+static unsigned long co_consumer_worker(void *arg, unsigned long n_ops) {
+    auto &r = *static_cast<decltype(perf_ring) *>(arg);
+    perf_expected = 0U;
+    perf_consumed.store(0U);
+    perf_consumer_co(r, n_ops);
+    return 0U;
+}
+static unsigned long co_producer_worker(void *arg, unsigned long n_ops) {
+    auto &r = *static_cast<decltype(perf_ring) *>(arg);
+    for (unsigned long i = 0U; i < n_ops; ++i) {
+        while (!r.try_push(static_cast<std::uint32_t>(i))) {
+        }
+    }
+    while (perf_consumed.load(std::memory_order_acquire) != n_ops) {
+    }
+    return n_ops;
+}
+
+static unsigned long cv_producer_worker(void *arg, unsigned long n_ops) {
+    auto &q = *static_cast<decltype(cv_queue) *>(arg);
+    for (unsigned long i = 0U; i < n_ops; ++i) {
+        q.push(static_cast<std::uint32_t>(i));
+    }
+    return n_ops;
+}
+static unsigned long cv_consumer_worker(void *arg, unsigned long n_ops) {
+    auto &q = *static_cast<decltype(cv_queue) *>(arg);
+    for (unsigned long i = 0U; i < n_ops; ++i) {
+        VERIFY(q.pop() == static_cast<std::uint32_t>(i));
+    }
+    return 0U;
+}
+#endif /* Q_HOST */
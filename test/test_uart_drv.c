@@ -0,0 +1,264 @@
+/*============================================================================
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2021 Quantum Leaps, LLC. All rights reserved.
+*
+* SPDX-License-Identifier: MIT
+*
+* Contact information:
+* <www.state-machine.com>
+* <info@state-machine.com>
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ring_buf.h"
+#include "uart_drv.h"
+#include "et.h" /* ET: embedded test */
+
+/* host simulation of the UART with TX/RX FIFOs in loopback (TX wired to
+* RX), running in virtual time: one character per 10 bit-times (8N1).
+* The TX interrupt fires when the TX FIFO is empty (TXFTCFG = empty),
+* and the RX interrupt when the RX FIFO reaches the threshold or the line
+* goes idle (a USART with FIFO mode, such as USART1 on STM32C031), or on
+* every character without a FIFO (USART2 in bsp_nucleo-c031c6.c). The
+* interrupt is served by the shared UartDrv_isr() and is assumed to be
+* immediate (no interrupt latency).
+*/
+#define SIM_MAX_DEPTH UART_DRV_MAX_BURST
+
+typedef struct {
+    uint8_t  depth;      /* FIFO depth (1 means no FIFO: TXE/RXNE) */
+    uint8_t  rx_thresh;  /* RX FIFO threshold */
+    uint32_t baud;       /* baud rate [bits/s] */
+    RingBufElement tx_fifo[SIM_MAX_DEPTH];
+    RingBufElement rx_fifo[SIM_MAX_DEPTH];
+    uint8_t  tx_level;
+    uint8_t  rx_level;
+    bool     txie;       /* TX threshold interrupt enabled */
+    bool     idle;       /* RX line idle after the last character */
+    uint64_t t_ns;       /* virtual time [ns] */
+    uint32_t n_irq;      /* number of UART interrupts */
+    uint32_t n_rx_overruns; /* RX FIFO overruns */
+    UartPort port;       /* registers for UartDrv_isr() */
+} UartSim;
+
+static UartSim sim;
+static UartDrv drv;
+static RingBufElement tx_sto[256];
+static RingBufElement rx_sto[64];
+
+static void sim_init(uint8_t depth, uint8_t rx_thresh, uint32_t baud);
+static bool sim_transfer(uint32_t n_bytes);
+
+static bool sim_tx_pending(void);
+static void sim_tx_write(RingBufElement const el);
+static void sim_tx_stop(void);
+static bool sim_rx_pending(void);
+static bool sim_rx_read(RingBufElement *pel);
+
+#ifdef Q_HOST
+/* performance test worker */
+static unsigned long sim_worker(void *arg, unsigned long n_ops);
+static unsigned long sim_bytes;
+static unsigned long sim_errors;
+#endif /* Q_HOST */
+
+void setup(void) {
+    /* executed before *every* non-skipped test */
+}
+
+void teardown(void) {
+    /* executed after *every* non-skipped and non-failing test */
+}
+
+/* test group --------------------------------------------------------------*/
+TEST_GROUP("interrupt-driven UART driver") {
+
+TEST("UART driver: 8-deep FIFOs, bursts per interrupt") {
+    sim_init(8U, 6U, 115200U);
+    VERIFY(true == sim_transfer(1000U));
+    VERIFY(0U == sim.n_rx_overruns);
+    VERIFY(0U == drv.rx_drops);
+    /* TX: 1 per 8 chars + 1 to stop; RX: 1 per 6 chars + idle */
+    VERIFY(sim.n_irq < 1000U/8U + 1000U/6U + 4U);
+    /* the TX line is never idle: 1000 char times, plus the idle-line
+    * detection for the last RX burst and the final idle char time
+    */
+    VERIFY(sim.t_ns <= (1000U + 3U) * ((10U * 1000000000ULL) / 115200U));
+}
+
+TEST("UART driver: no FIFO, one interrupt per character") {
+    sim_init(1U, 1U, 115200U);
+    VERIFY(true == sim_transfer(1000U));
+    VERIFY(0U == sim.n_rx_overruns);
+    VERIFY(0U == drv.rx_drops);
+    /* exactly one interrupt per character: the RXNE of each character
+    * coincides with the TXE that sends the next one (or stops the TX
+    * interrupts after the last one), plus the first TXE
+    */
+    VERIFY(sim.n_irq == 1000U + 1U);
+}
+
+#ifdef Q_HOST
+/* host CPU cost of the driver per character (ops/s), the interrupts per
+* character (irq/op), and the simulated time per character (sim-ns/op)
+*/
+PERF_TEST("perf: UART driver sim 3 Mbaud, 8-deep FIFOs", 0U, 100U) {
+    sim_init(8U, 6U, 3000000U);
+    ET_perf_worker(&sim_worker, (void *)0, 0);
+    ET_perf_run();
+    VERIFY(0U == sim_errors);
+    ET_perf_counter_("irq", (100U * (unsigned long)sim.n_irq) / sim_bytes);
+    ET_perf_counter_("sim-ns",
+                     (unsigned long)((100U * sim.t_ns) / sim_bytes));
+}
+
+PERF_TEST("perf: UART driver sim 3 Mbaud, no FIFO", 0U, 100U) {
+    sim_init(1U, 1U, 3000000U);
+    ET_perf_worker(&sim_worker, (void *)0, 0);
+    ET_perf_run();
+    VERIFY(0U == sim_errors);
+    ET_perf_counter_("irq", (100U * (unsigned long)sim.n_irq) / sim_bytes);
+    ET_perf_counter_("sim-ns",
+                     (unsigned long)((100U * sim.t_ns) / sim_bytes));
+}
+#endif /* Q_HOST */
+
+} /* TEST_GROUP() */
+
+/*..........................................................................*/
+static void sim_init(uint8_t depth, uint8_t rx_thresh, uint32_t baud) {
+    sim.depth     = depth;
+    sim.rx_thresh = rx_thresh;
+    sim.baud      = baud;
+    sim.tx_level  = 0U;
+    sim.rx_level  = 0U;
+    sim.txie      = false;
+    sim.idle      = false;
+    sim.t_ns      = 0U;
+    sim.n_irq     = 0U;
+    sim.n_rx_overruns = 0U;
+    sim.port.fifo_depth = depth;
+    sim.port.tx_pending = &sim_tx_pending;
+    sim.port.tx_write   = &sim_tx_write;
+    sim.port.tx_stop    = &sim_tx_stop;
+    sim.port.rx_pending = &sim_rx_pending;
+    sim.port.rx_read    = &sim_rx_read;
+    UartDrv_ctor(&drv, tx_sto, ARRAY_NELEM(tx_sto),
+                 rx_sto, ARRAY_NELEM(rx_sto));
+}
+/*..........................................................................*/
+/* the simulated USART registers for the shared UartDrv_isr() */
+static bool sim_tx_pending(void) {
+    return sim.txie && (sim.tx_level == 0U);
+}
+static void sim_tx_write(RingBufElement const el) {
+    sim.tx_fifo[sim.tx_level++] = el;
+}
+static void sim_tx_stop(void) {
+    sim.txie = false;
+}
+static bool sim_rx_pending(void) {
+    return (sim.rx_level >= sim.rx_thresh)
+           || (sim.idle && (sim.rx_level != 0U));
+}
+static bool sim_rx_read(RingBufElement *pel) {
+    if (sim.rx_level == 0U) {
+        return false;
+    }
+    *pel = sim.rx_fifo[0];
+    for (uint8_t i = 1U; i < sim.rx_level; ++i) {
+        sim.rx_fifo[i - 1U] = sim.rx_fifo[i];
+    }
+    --sim.rx_level;
+    return true;
+}
+/*..........................................................................*/
+/* the simulated USART interrupt, served by the same UartDrv_isr() as
+* USART2_IRQHandler() in the BSP
+*/
+static void sim_isr(void) {
+    if (!sim_tx_pending() && !sim_rx_pending()) {
+        return;
+    }
+    ++sim.n_irq;
+    UartDrv_isr(&drv, &sim.port);
+}
+/*..........................................................................*/
+/* one character time on the wire: TX FIFO -> shift register -> RX FIFO */
+static void sim_char_time(void) {
+    sim.t_ns += (10U * 1000000000ULL) / sim.baud;
+    if (sim.tx_level != 0U) {
+        RingBufElement const ch = sim.tx_fifo[0];
+        for (uint8_t i = 1U; i < sim.tx_level; ++i) {
+            sim.tx_fifo[i - 1U] = sim.tx_fifo[i];
+        }
+        --sim.tx_level;
+        if (sim.rx_level < sim.depth) {
+            sim.rx_fifo[sim.rx_level++] = ch;
+        }
+        else {
+            ++sim.n_rx_overruns;
+        }
+        sim.idle = false;
+    }
+    else {
+        sim.idle = true;
+    }
+}
+/*..........................................................................*/
+/* send 'n_bytes' through the driver and check that they come back */
+static bool sim_transfer(uint32_t n_bytes) {
+    uint32_t n_tx = 0U;
+    uint32_t n_rx = 0U;
+    while (n_rx < n_bytes) {
+        /* application: queue as much as fits, start the TX interrupts */
+        RingBufElement chunk[32];
+        RingBufCtr n = (RingBufCtr)ARRAY_NELEM(chunk);
+        if (n > n_bytes - n_tx) {
+            n = (RingBufCtr)(n_bytes - n_tx);
+        }
+        for (RingBufCtr i = 0U; i < n; ++i) {
+            chunk[i] = (RingBufElement)(n_tx + i);
+        }
+        n_tx += UartDrv_write(&drv, chunk, n);
+        sim.txie = true;
+
+        sim_isr();
+        sim_char_time();
+        sim_isr();
+
+        /* application: read back what was received */
+        RingBufCtr const n_got =
+            UartDrv_read(&drv, chunk, (RingBufCtr)ARRAY_NELEM(chunk));
+        for (RingBufCtr i = 0U; i < n_got; ++i) {
+            if (chunk[i] != (RingBufElement)(n_rx + i)) {
+                return false;
+            }
+        }
+        n_rx += n_got;
+    }
+    /* let the line go idle, so the next transfer starts from scratch */
+    sim_char_time();
+    sim_isr();
+    return true;
+}
+
+#ifdef Q_HOST
+static unsigned long sim_worker(void *arg, unsigned long n_ops) {
+    (void)arg;
+    sim_bytes  = 0U;
+    sim_errors = 0U;
+    while ((sim_bytes < n_ops) && !ET_perf_stop()) {
+        if (!sim_transfer(1000U)) {
+            ++sim_errors;
+        }
+        sim_bytes += 1000U;
+    }
+    return sim_bytes;
+}
+#endif /* Q_HOST */
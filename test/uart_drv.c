@@ -0,0 +1,73 @@
+/*============================================================================
+* Ring-buffered, interrupt-driven UART driver (hardware-independent part)
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+*
+* SPDX-License-Identifier: MIT
+============================================================================*/
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "uart_drv.h"
+
+/*..........................................................................*/
+void UartDrv_ctor(UartDrv * const me,
+                  RingBufElement tx_sto[], RingBufCtr tx_len,
+                  RingBufElement rx_sto[], RingBufCtr rx_len)
+{
+    RingBuf_ctor(&me->tx, tx_sto, tx_len);
+    RingBuf_ctor(&me->rx, rx_sto, rx_len);
+    me->rx_drops = 0U;
+}
+/*..........................................................................*/
+RingBufCtr UartDrv_write(UartDrv * const me,
+                         RingBufElement const data[], RingBufCtr n)
+{
+    return RingBuf_put_n(&me->tx, data, n);
+}
+/*..........................................................................*/
+RingBufCtr UartDrv_read(UartDrv * const me,
+                        RingBufElement data[], RingBufCtr n)
+{
+    return RingBuf_get_n(&me->rx, data, n);
+}
+/*..........................................................................*/
+RingBufCtr UartDrv_txIsr(UartDrv * const me,
+                         RingBufElement burst[], RingBufCtr fifo_free)
+{
+    return RingBuf_get_n(&me->tx, burst, fifo_free);
+}
+/*..........................................................................*/
+void UartDrv_rxIsr(UartDrv * const me,
+                   RingBufElement const burst[], RingBufCtr n)
+{
+    me->rx_drops += (uint32_t)(n - RingBuf_put_n(&me->rx, burst, n));
+}
+/*..........................................................................*/
+void UartDrv_isr(UartDrv * const me, UartPort const * const port) {
+    RingBufElement burst[UART_DRV_MAX_BURST];
+
+    /* TX FIFO empty: refill it with one burst from the TX ring buffer */
+    if ((*port->tx_pending)()) {
+        RingBufCtr const n = UartDrv_txIsr(me, burst, port->fifo_depth);
+        for (RingBufCtr i = 0U; i < n; ++i) {
+            (*port->tx_write)(burst[i]);
+        }
+        if (n == 0U) { /* nothing more to send? */
+            (*port->tx_stop)();
+        }
+    }
+
+    /* RX FIFO threshold or idle line: drain the RX FIFO in one burst */
+    if ((*port->rx_pending)()) {
+        RingBufCtr n = 0U;
+        while ((n < port->fifo_depth) && (*port->rx_read)(&burst[n])) {
+            ++n;
+        }
+        UartDrv_rxIsr(me, burst, n);
+    }
+}
@@ -0,0 +1,68 @@
+/*============================================================================
+* Ring-buffered, interrupt-driven UART driver (hardware-independent part)
+*
+*                    Q u a n t u m  L e a P s
+*                    ------------------------
+*                    Modern Embedded Software
+*
+* Copyright (C) 2005 Quantum Leaps, <state-machine.com>.
+*
+* SPDX-License-Identifier: MIT
+============================================================================*/
+#ifndef UART_DRV_H
+#define UART_DRV_H
+
+#include "ring_buf.h"
+
+/* The application writes into the TX ring buffer and reads from the RX
+* ring buffer. The UART interrupt (UartDrv_isr()) moves whole bursts
+* between the ring buffers and the UART FIFOs (FIFO threshold
+* interrupts), so there is one interrupt per FIFO-full of characters
+* rather than per character. Without a FIFO (e.g., USART2 on STM32C031),
+* the bursts are one character long (TXE/RXNE interrupts).
+* The register access stays in the BSP (bsp_nucleo-c031c6.c) or in the
+* host simulation (test_uart_drv.c), behind the UartPort functions.
+*/
+#define UART_DRV_MAX_BURST 16U /* max. FIFO depth handled by UartDrv_isr() */
+typedef struct {
+    RingBuf tx;        /* application -> TX ISR */
+    RingBuf rx;        /* RX ISR -> application */
+    uint32_t rx_drops; /* characters lost because the RX ring was full */
+} UartDrv;
+
+void UartDrv_ctor(UartDrv * const me,
+                  RingBufElement tx_sto[], RingBufCtr tx_len,
+                  RingBufElement rx_sto[], RingBufCtr rx_len);
+
+/* application side: returns the number of characters written/read */
+RingBufCtr UartDrv_write(UartDrv * const me,
+                         RingBufElement const data[], RingBufCtr n);
+RingBufCtr UartDrv_read(UartDrv * const me,
+                        RingBufElement data[], RingBufCtr n);
+
+/* TX ISR side: fills 'burst' with up to 'fifo_free' characters for the
+* TX FIFO and returns their number (0 means: disable the TX interrupt)
+*/
+RingBufCtr UartDrv_txIsr(UartDrv * const me,
+                         RingBufElement burst[], RingBufCtr fifo_free);
+
+/* RX ISR side: stores 'n' characters read from the RX FIFO */
+void UartDrv_rxIsr(UartDrv * const me,
+                   RingBufElement const burst[], RingBufCtr n);
+
+/* UART registers used by UartDrv_isr(), provided by the BSP or the
+* host simulation
+*/
+typedef struct {
+    RingBufCtr fifo_depth;         /* 1 means no FIFO (TXE/RXNE) */
+    bool (*tx_pending)(void);      /* TX interrupt enabled and pending? */
+    void (*tx_write)(RingBufElement const el); /* write TX data register */
+    void (*tx_stop)(void);         /* disable the TX interrupt */
+    bool (*rx_pending)(void);      /* RX interrupt pending (clears it)? */
+    bool (*rx_read)(RingBufElement *pel); /* read RX data, if available */
+} UartPort;
+
+/* the UART interrupt handler shared by the BSP and the host simulation */
+void UartDrv_isr(UartDrv * const me, UartPort const * const port);
+
+#endif /* UART_DRV_H */